@@ -13,6 +13,7 @@
 	#include "srp_datatypes.h"
 #endif
 #include "data-parser.h"
+#include "memprof.h"
 
 /*
  * Return JSON node "nodes" from given file
@@ -97,7 +98,7 @@ SRP_NetworkNode_t* jsonNode_to_SRP_NetworkNode(json_t *node){
   }
 
   // create SRP node
-  srp_node = SRP_NetworkNode_create();
+  srp_node = memprof_SRP_NetworkNode_create(MEMPROF_STAGE_NETWORK);
   if (NULL == srp_node) {
     return NULL;
   }
@@ -147,7 +148,7 @@ SRP_NetworkNode_t* jsonNode_to_SRP_NetworkNode(json_t *node){
       return NULL;
     }
 
-    new_neighbour = SRP_NetworkNode_create();
+    new_neighbour = memprof_SRP_NetworkNode_create(MEMPROF_STAGE_NEIGHBOURS);
     if (NULL == new_neighbour) {
       return NULL;
     }
@@ -192,7 +193,7 @@ SRP_Network_t* json_data_to_network(json_t *nodes){
   }
 
   // create first (dummy) element in network
-  srp_nw_ptr = SRP_Network_create();
+  srp_nw_ptr = memprof_SRP_Network_create();
   if (NULL == srp_nw_ptr) {
     return NULL;
   }
@@ -212,7 +213,7 @@ SRP_Network_t* json_data_to_network(json_t *nodes){
       return NULL;
     }
     // create new network list element
-    srp_nw_ptr->next = (struct SRP_Network_t*)SRP_Network_create();
+    srp_nw_ptr->next = (struct SRP_Network_t*)memprof_SRP_Network_create();
     if (NULL == srp_nw_ptr->next) {
       return NULL;
     }
@@ -225,12 +226,77 @@ SRP_Network_t* json_data_to_network(json_t *nodes){
   // remove first dummy element
   srp_nw_ptr = srp_root_ptr;
   srp_root_ptr = (SRP_Network_t*)srp_nw_ptr->next;
-  free(srp_nw_ptr);
+  memprof_free(MEMPROF_STAGE_NETWORK, srp_nw_ptr, sizeof(SRP_Network_t));
 
   return srp_root_ptr;
 }
 
 
+/*
+ * Release a network created by json_data_to_network(), including its nodes and their neighbour entries.
+ * @param network to be released (may be NULL)
+ */
+void free_network(SRP_Network_t *network) {
+  SRP_Network_t *next_element = NULL;       //< list element following the current one
+  SRP_NetworkNode_t *neighbour = NULL;      //< current neighbour entry
+  SRP_NetworkNode_t *next_neighbour = NULL; //< neighbour entry following the current one
+
+  while (NULL != network) {
+    next_element = (SRP_Network_t*)network->next;
+    if (NULL != network->data) {
+      neighbour = (SRP_NetworkNode_t*)network->data->neighbours;
+      while (NULL != neighbour) {
+        next_neighbour = (SRP_NetworkNode_t*)neighbour->neighbours;
+        memprof_free(MEMPROF_STAGE_NEIGHBOURS, neighbour, sizeof(SRP_NetworkNode_t));
+        neighbour = next_neighbour;
+      }
+      memprof_free(MEMPROF_STAGE_NETWORK, network->data, sizeof(SRP_NetworkNode_t));
+    }
+    memprof_free(MEMPROF_STAGE_NETWORK, network, sizeof(SRP_Network_t));
+    network = next_element;
+  }
+}
+
+
+/*
+ * Comparison function for sorting node IDs (of type long long) with qsort() / bsearch()
+ * @returns negative, zero or positive if "a" is less than, equal to or greater than "b"
+ */
+int compare_ids(const void *a, const void *b) {
+  long long id_a = *(const long long*)a;  //< first ID
+  long long id_b = *(const long long*)b;  //< second ID
+
+  if (id_a < id_b) {
+    return -1;
+  }
+  if (id_a > id_b) {
+    return 1;
+  }
+  return 0;
+}
+
+
+/*
+ * Release a route and all of its hops.
+ * @param route to be released (may be NULL)
+ */
+void free_route(SRP_node_list_t *route) {
+  SRP_node_list_element_t *hop = NULL;   //< current hop
+  SRP_node_list_element_t *next = NULL;  //< hop following the current one
+
+  if (NULL == route) {
+    return;
+  }
+  hop = route->start;
+  while (NULL != hop) {
+    next = (SRP_node_list_element_t*)hop->next;
+    free(hop);
+    hop = next;
+  }
+  free(route);
+}
+
+
 /*
  * Convert JSON object to routing criterion.
  * @param json points to the JSON object to be converted
@@ -239,9 +305,9 @@ SRP_Network_t* json_data_to_network(json_t *nodes){
  */
 SRP_RoutingCriterion_t* json_to_routing_criterion(json_t *json) {
   json_t* token = NULL;                     //< key to be retrieved from JSON data
-  char* metric_identifier = NULL;           //< metric identifier of a rule
-  char* operator = NULL;                    //< operator of a rule
-  char* value = NULL;                       //< value of a rule
+  char* metric_identifier = NULL;           //< metric identifier of a rule (owned by the JSON document)
+  char* operator = NULL;                    //< operator of a rule (owned by the JSON document)
+  char* value = NULL;                       //< value of a rule (owned by the JSON document)
   char* rule = NULL;                        //< final rule string
   SRP_RoutingCriterion_t* criterion = NULL; //< routing criterion to be returned
 
@@ -287,7 +353,6 @@ SRP_RoutingCriterion_t* json_to_routing_criterion(json_t *json) {
   operator = (char*)json_string_value(token);
   if (NULL == operator) {
     fprintf(stdout, "extracting the rule operator failed\n");
-    free(metric_identifier);
     return NULL;
   }
 
@@ -303,17 +368,12 @@ SRP_RoutingCriterion_t* json_to_routing_criterion(json_t *json) {
   value = (char*)json_string_value(token);
   if (NULL == value) {
     fprintf(stdout, "extracting the value failed\n");
-    free(metric_identifier);
-    free(operator);
     return NULL;
   }
 
-  criterion = (SRP_RoutingCriterion_t*)malloc(sizeof(SRP_RoutingCriterion_t));
+  criterion = (SRP_RoutingCriterion_t*)memprof_malloc(MEMPROF_STAGE_CRITERIA, sizeof(SRP_RoutingCriterion_t));
   if (NULL == criterion) {
 	  fprintf(stderr, "allocating memory for the routing criterion failed\n");
-	  free(metric_identifier);
-	  free(operator);
-	  free(value);
 	  return NULL;
   }
 
@@ -345,6 +405,7 @@ SRP_ObjectiveFunction_t* extract_objective_functions(const char* filename){
   SRP_RoutingCriterion_t *current_criterion = NULL;           //< current criterion to be worked with
   SRP_RoutingCriterion_t *last_criterion = NULL;              //< the currently last criterion in the list
   char* of_id = NULL;        //< metric identifier for an objective function
+  int stage = 0;             //< profiling stage of JSON allocations before loading
 
 
   if (NULL == filename) {
@@ -352,7 +413,10 @@ SRP_ObjectiveFunction_t* extract_objective_functions(const char* filename){
   }
   
   // do initial read of the data + some sanity checks
+  // (a second copy of the whole file, profiled apart from the first document and the criteria themselves)
+  stage = memprof_set_json_stage(MEMPROF_STAGE_OBJECTIVES_JSON);
   json = json_load_file(filename, 0, &json_error);
+  memprof_set_json_stage(stage);
   if (!json) {
     fprintf(stderr, "%s\n", json_error.text);
     return NULL;
@@ -393,7 +457,7 @@ SRP_ObjectiveFunction_t* extract_objective_functions(const char* filename){
       fprintf(stderr, "'id'-key not associated with a number-value\n");
       continue;
     }
-    of_id = (char*)calloc(21, sizeof(char)); //based on 20 chars of unsigned long long (+\n)
+    of_id = (char*)memprof_calloc(MEMPROF_STAGE_CRITERIA, 21, sizeof(char)); //based on 20 chars of unsigned long long (+\n)
     if (NULL == of_id) {
       fprintf(stdout, "allocating memory for the metric identifier failed\n");
       return NULL;
@@ -404,25 +468,25 @@ SRP_ObjectiveFunction_t* extract_objective_functions(const char* filename){
     criteria = json_object_get(of, "criteria");
     if (!criteria) {
       fprintf(stderr, "'criteria'-key not found\n");
-      free(of_id);
+      memprof_free(MEMPROF_STAGE_CRITERIA, of_id, 21 * sizeof(char));
       return NULL;
     }
     if (!json_is_array(criteria)) {
       fprintf(stderr, "'criteria'-key not associated with an array\n");
-      free(of_id);
+      memprof_free(MEMPROF_STAGE_CRITERIA, of_id, 21 * sizeof(char));
       return NULL;
     }
 
-    start_ptr = (SRP_ObjectiveFunction_t*)malloc(sizeof(SRP_ObjectiveFunction_t));
+    start_ptr = (SRP_ObjectiveFunction_t*)memprof_malloc(MEMPROF_STAGE_CRITERIA, sizeof(SRP_ObjectiveFunction_t));
     if (NULL == start_ptr) {
       fprintf(stderr, "allocating memory for the objective function data-structure failed\n");
-      free(of_id);
+      memprof_free(MEMPROF_STAGE_CRITERIA, of_id, 21 * sizeof(char));
       return NULL;
     }
     current_objective_ptr = start_ptr;
     current_objective_ptr->id = of_id;
     current_objective_ptr->criteria = NULL;
-    free(of_id);
+    memprof_free(MEMPROF_STAGE_CRITERIA, of_id, 21 * sizeof(char));
 
     //@todo fill data-structures
     json_array_foreach(criteria, j, rulejson){
@@ -443,6 +507,91 @@ SRP_ObjectiveFunction_t* extract_objective_functions(const char* filename){
 }
 
 
+/*
+ * @brief Check whether a JSON network node fulfils the node criteria of an objective function.
+ * The metric "owner" refers to the "node owner" of the node, "node energy" to the "level" of
+ * its "node energy" and any other metric to the numeric attribute of the same name.
+ * The link metrics "latency" and "throughput" are not node criteria and therefore not checked.
+ * A node lacking the attribute of a node criterion does not fulfil it.
+ *
+ * @param node from the JSON data-structure
+ * @param of objective function to be checked (NULL is fulfilled by every node)
+ * @param skip_energy skips "node energy" criteria if non-zero (for callers checking them along the path)
+ * @returns 1 if the node fulfils all node criteria, 0 otherwise
+ */
+int json_node_fulfils_objective_function(json_t *node, SRP_ObjectiveFunction_t *of, int skip_energy) {
+  SRP_RoutingCriterion_t *criterion = NULL;  //< current criterion
+  json_t *element_ptr = NULL;                //< attribute the criterion refers to
+  double attribute = 0.0;                    //< value of the attribute
+  double value = 0.0;                        //< value of the criterion
+  char *end = NULL;                          //< end of the parsed value
+  int fulfilled = 0;                         //< current criterion is fulfilled
+
+  if (NULL == of) {
+    return 1;
+  }
+  if (!json_is_object(node)) {
+    return 0;
+  }
+
+  for (criterion = of->criteria; NULL != criterion;
+       criterion = (SRP_RoutingCriterion_t*)criterion->next) {
+    if ((NULL == criterion->metric_identifier) || (NULL == criterion->operator) || (NULL == criterion->value)) {
+      continue;
+    }
+    if ((0 == strcmp("latency", criterion->metric_identifier)) ||
+        (0 == strcmp("throughput", criterion->metric_identifier))) {
+      continue;
+    }
+    if (skip_energy && (0 == strcmp("node energy", criterion->metric_identifier))) {
+      continue;
+    }
+
+    if (0 == strcmp("owner", criterion->metric_identifier)) {
+      element_ptr = json_object_get(node, "node owner");
+    } else if (0 == strcmp("node energy", criterion->metric_identifier)) {
+      element_ptr = json_object_get(json_object_get(node, "node energy"), "level");
+    } else {
+      element_ptr = json_object_get(node, criterion->metric_identifier);
+    }
+    if (!json_is_number(element_ptr)) {
+      return 0;
+    }
+    attribute = json_number_value(element_ptr);
+
+    value = strtod(criterion->value, &end);
+    if (end == criterion->value) {
+      fprintf(stderr, "value \"%s\" of criterion \"%s\" is not a number\n",
+              criterion->value, criterion->metric_identifier);
+      return 0;
+    }
+
+    if (0 == strcmp("<", criterion->operator)) {
+      fulfilled = (attribute < value);
+    } else if (0 == strcmp("<=", criterion->operator)) {
+      fulfilled = (attribute <= value);
+    } else if (0 == strcmp("==", criterion->operator)) {
+      fulfilled = (attribute == value);
+    } else if (0 == strcmp("!=", criterion->operator)) {
+      fulfilled = (attribute != value);
+    } else if (0 == strcmp(">=", criterion->operator)) {
+      fulfilled = (attribute >= value);
+    } else if (0 == strcmp(">", criterion->operator)) {
+      fulfilled = (attribute > value);
+    } else {
+      fprintf(stderr, "unknown operator \"%s\" in criterion \"%s\"\n",
+              criterion->operator, criterion->metric_identifier);
+      fulfilled = 0;
+    }
+    if (!fulfilled) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+
 /*
  * @brief Filter a given network according to a given objective function.
  * This function reduces the network to all the nodes fulfilling the conditions
@@ -582,3 +731,401 @@ int write_route_to_JSON_file(const char *filename, int route_id, SRP_node_list_t
 
 	  return 1;
 }
+
+
+/*
+ * Hash a node ID for a node_index_t.
+ */
+static size_t node_index_hash(long long id, size_t bucket_count) {
+  unsigned long long hash = (unsigned long long)id * 0x9E3779B97F4A7C15ULL;  //< Fibonacci hashing
+
+  return (size_t)(hash ^ (hash >> 32)) & (bucket_count - 1);
+}
+
+
+/*
+ * @brief Prepare an empty node index for up to "node_count" nodes.
+ * The index is the build side of the joins turning neighbour IDs into node positions;
+ * every router resolving IDs shares it.
+ * @param index to be prepared
+ * @param node_count maximum number of nodes to be inserted
+ * @returns 1 in case of success, 0 otherwise
+ * @see node_index_free(node_index_t *index)
+ */
+int node_index_init(node_index_t *index, size_t node_count) {
+  size_t i = 0;  //< current bucket
+
+  index->bucket_count = 1;
+  while (index->bucket_count < 2 * node_count) {
+    index->bucket_count *= 2;
+  }
+  index->ids = (long long*)memprof_malloc(MEMPROF_STAGE_RESOLVED, index->bucket_count * sizeof(long long));
+  index->positions = (size_t*)memprof_malloc(MEMPROF_STAGE_RESOLVED, index->bucket_count * sizeof(size_t));
+  if ((NULL == index->ids) || (NULL == index->positions)) {
+    fprintf(stderr, "allocating memory for the node index failed\n");
+    node_index_free(index);
+    return 0;
+  }
+  for (i = 0; i < index->bucket_count; i++) {
+    index->positions[i] = RESOLVED_NONE;
+  }
+  return 1;
+}
+
+
+/*
+ * Insert a node into a node index.
+ * @param index to insert into
+ * @param id of the node
+ * @param position of the node in its array (must not be RESOLVED_NONE)
+ * @returns 1 in case of success, 0 if the ID is already present
+ */
+int node_index_insert(node_index_t *index, long long id, size_t position) {
+  size_t bucket = 0;  //< current bucket
+
+  bucket = node_index_hash(id, index->bucket_count);
+  while (RESOLVED_NONE != index->positions[bucket]) {
+    if (id == index->ids[bucket]) {
+      return 0;
+    }
+    bucket = (bucket + 1) & (index->bucket_count - 1);
+  }
+  index->ids[bucket] = id;
+  index->positions[bucket] = position;
+  return 1;
+}
+
+
+/*
+ * Find a node in a node index.
+ * @param index to be searched
+ * @param id of the node
+ * @returns position of the node in case of success, RESOLVED_NONE otherwise
+ */
+size_t node_index_find(const node_index_t *index, long long id) {
+  size_t bucket = 0;  //< current bucket
+
+  if ((NULL == index) || (NULL == index->positions)) {
+    return RESOLVED_NONE;
+  }
+  bucket = node_index_hash(id, index->bucket_count);
+  while (RESOLVED_NONE != index->positions[bucket]) {
+    if (id == index->ids[bucket]) {
+      return index->positions[bucket];
+    }
+    bucket = (bucket + 1) & (index->bucket_count - 1);
+  }
+  return RESOLVED_NONE;
+}
+
+
+/*
+ * Release the tables of a node index (the index itself is not freed).
+ * @param index to be released
+ */
+void node_index_free(node_index_t *index) {
+  memprof_free(MEMPROF_STAGE_RESOLVED, index->ids, index->bucket_count * sizeof(long long));
+  memprof_free(MEMPROF_STAGE_RESOLVED, index->positions, index->bucket_count * sizeof(size_t));
+  index->ids = NULL;
+  index->positions = NULL;
+  index->bucket_count = 0;
+}
+
+
+/*
+ * Sort a list of IDs and remove duplicates.
+ * @param ids to be sorted
+ * @param count number of IDs
+ * @returns the new number of IDs
+ */
+size_t sort_unique_ids(long long *ids, size_t count) {
+  size_t i, j = 0;  //< read and write position
+
+  if (0 == count) {
+    return 0;
+  }
+  qsort(ids, count, sizeof(long long), compare_ids);
+  for (i = 1, j = 1; i < count; i++) {
+    if (ids[i] != ids[j - 1]) {
+      ids[j++] = ids[i];
+    }
+  }
+  return j;
+}
+
+
+/*
+ * Report the IDs of referenced but missing nodes on one line.
+ * @param ids of the missing nodes (as returned by sort_unique_ids())
+ * @param count number of missing nodes, nothing is reported for 0
+ */
+void report_dangling_references(const long long *ids, size_t count) {
+  size_t i = 0;  //< index in the list
+
+  if (0 == count) {
+    return;
+  }
+  fprintf(stderr, "%zu referenced neighbours not found:", count);
+  for (i = 0; i < count; i++) {
+    fprintf(stderr, " %lli", ids[i]);
+  }
+  fprintf(stderr, "\n");
+}
+
+
+/*
+ * Find a node of a resolved network by its ID.
+ * @param resolved network to be searched
+ * @param id of the node
+ * @returns index of the node in case of success, RESOLVED_NONE otherwise
+ */
+size_t resolved_network_find(resolved_network_t *resolved, long long id) {
+  if (NULL == resolved) {
+    return RESOLVED_NONE;
+  }
+  return node_index_find(&resolved->index, id);
+}
+
+
+/*
+ * Remember the ID of a referenced but missing node.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int resolved_network_add_dangling(resolved_network_t *resolved, long long id) {
+  long long *resized = NULL;  //< dangling list after growing it
+  size_t capacity = 0;        //< allocated entries after growing
+
+  if (resolved->dangling_capacity == resolved->dangling_count) {
+    capacity = 2 * (resolved->dangling_capacity + 4);
+    resized = (long long*)memprof_realloc(MEMPROF_STAGE_RESOLVED, resolved->dangling,
+                                          resolved->dangling_capacity * sizeof(long long),
+                                          capacity * sizeof(long long));
+    if (NULL == resized) {
+      fprintf(stderr, "allocating memory for the dangling references failed\n");
+      return 0;
+    }
+    resolved->dangling = resized;
+    resolved->dangling_capacity = capacity;
+  }
+  resolved->dangling[resolved->dangling_count++] = id;
+  return 1;
+}
+
+
+/*
+ * Sort the dangling list so every missing node is reported once.
+ */
+static void resolved_network_unique_dangling(resolved_network_t *resolved) {
+  resolved->dangling_count = sort_unique_ids(resolved->dangling, resolved->dangling_count);
+}
+
+
+/*
+ * Build the node index of a network: count nodes and neighbour references and
+ * fill the hash table mapping node IDs to node indices. No links are built.
+ * @returns resolved_network_t pointer in case of success, NULL otherwise
+ */
+static resolved_network_t* resolved_network_index(SRP_Network_t *network) {
+  resolved_network_t *resolved = NULL;  //< resolved network to be constructed
+  SRP_Network_t *element = NULL;        //< current element of the network list
+  SRP_NetworkNode_t *neighbour = NULL;  //< current neighbour entry
+  size_t i = 0;                         //< generic index
+
+  resolved = (resolved_network_t*)memprof_calloc(MEMPROF_STAGE_RESOLVED, 1, sizeof(resolved_network_t));
+  if (NULL == resolved) {
+    fprintf(stderr, "allocating memory for the resolved network failed\n");
+    return NULL;
+  }
+
+  // count nodes and neighbour references
+  for (element = network; NULL != element; element = (SRP_Network_t*)element->next) {
+    if (NULL == element->data) {
+      continue;
+    }
+    resolved->node_count++;
+    neighbour = (SRP_NetworkNode_t*)element->data->neighbours;
+    for (; NULL != neighbour; neighbour = (SRP_NetworkNode_t*)neighbour->neighbours) {
+      resolved->edge_count++;
+    }
+  }
+
+  resolved->nodes = (SRP_NetworkNode_t**)memprof_malloc(MEMPROF_STAGE_RESOLVED,
+                                                        (resolved->node_count + 1) * sizeof(SRP_NetworkNode_t*));
+  if (NULL == resolved->nodes) {
+    fprintf(stderr, "allocating memory for the resolved network failed\n");
+    resolved_network_free(resolved);
+    return NULL;
+  }
+  if (!node_index_init(&resolved->index, resolved->node_count)) {
+    resolved_network_free(resolved);
+    return NULL;
+  }
+
+  // build side of the join: node ID -> node index
+  i = 0;
+  for (element = network; NULL != element; element = (SRP_Network_t*)element->next) {
+    if (NULL == element->data) {
+      continue;
+    }
+    if (!node_index_insert(&resolved->index, element->data->id, i)) {
+      fprintf(stderr, "node %lli defined more than once\n", element->data->id);
+      resolved_network_free(resolved);
+      return NULL;
+    }
+    resolved->nodes[i] = element->data;
+    i++;
+  }
+
+  return resolved;
+}
+
+
+/*
+ * @brief Check the neighbour references of a converted network without resolving them.
+ * Only the node index is built; "first_edge" and "edges" stay NULL and "edge_count"
+ * holds the number of neighbour references (duplicates included).
+ * References to missing nodes are collected in "dangling".
+ *
+ * @param network to be checked (as returned by json_data_to_network())
+ * @returns resolved_network_t pointer in case of success, NULL otherwise
+ * @see resolved_network_free(resolved_network_t *resolved)
+ */
+resolved_network_t* check_network_references(SRP_Network_t *network) {
+  resolved_network_t *resolved = NULL;  //< indexed network
+  SRP_NetworkNode_t *neighbour = NULL;  //< current neighbour entry
+  size_t i = 0;                         //< generic index
+
+  // sanity checks
+  if (NULL == network) {
+    return NULL;
+  }
+
+  resolved = resolved_network_index(network);
+  if (NULL == resolved) {
+    return NULL;
+  }
+  for (i = 0; i < resolved->node_count; i++) {
+    neighbour = (SRP_NetworkNode_t*)resolved->nodes[i]->neighbours;
+    for (; NULL != neighbour; neighbour = (SRP_NetworkNode_t*)neighbour->neighbours) {
+      if (RESOLVED_NONE != resolved_network_find(resolved, neighbour->id)) {
+        continue;
+      }
+      if (!resolved_network_add_dangling(resolved, neighbour->id)) {
+        resolved_network_free(resolved);
+        return NULL;
+      }
+    }
+  }
+  resolved_network_unique_dangling(resolved);
+
+  return resolved;
+}
+
+
+/*
+ * @brief Resolve the neighbour references of a converted network.
+ * A single hash join turns the neighbour IDs of every node into the index of the
+ * referenced node. Links are stored as compact (target, weight) records; duplicate
+ * links between the same pair of nodes are merged, keeping the smallest weight.
+ * References to missing nodes are skipped and collected in "dangling", unless
+ * RESOLVE_SKIP_DANGLING is given.
+ *
+ * @param network to be resolved (as returned by json_data_to_network())
+ * @param flags RESOLVE_RELEASE_NEIGHBOURS and/or RESOLVE_SKIP_DANGLING, 0 for none
+ * @returns resolved_network_t pointer in case of success, NULL otherwise
+ * @see resolved_network_find(resolved_network_t *resolved, long long id)
+ */
+resolved_network_t* resolve_network(SRP_Network_t *network, int flags) {
+  resolved_network_t *resolved = NULL;      //< resolved network to be constructed
+  SRP_NetworkNode_t *neighbour = NULL;      //< current neighbour entry
+  SRP_NetworkNode_t *next_neighbour = NULL; //< neighbour entry following the current one
+  size_t *last_source = NULL;               //< last node linking to every node (for merging duplicates)
+  size_t *last_edge = NULL;                 //< link created by that node
+  size_t target = 0;                        //< index of the current neighbour
+  size_t i = 0;                             //< generic index
+
+  // sanity checks
+  if (NULL == network) {
+    return NULL;
+  }
+
+  resolved = resolved_network_index(network);
+  if (NULL == resolved) {
+    return NULL;
+  }
+  resolved->edge_capacity = resolved->edge_count + 1;
+  resolved->first_edge = (size_t*)memprof_malloc(MEMPROF_STAGE_RESOLVED, (resolved->node_count + 1) * sizeof(size_t));
+  resolved->edges = (network_edge_t*)memprof_malloc(MEMPROF_STAGE_RESOLVED,
+                                                    resolved->edge_capacity * sizeof(network_edge_t));
+  last_source = (size_t*)memprof_malloc(MEMPROF_STAGE_RESOLVED, (resolved->node_count + 1) * sizeof(size_t));
+  last_edge = (size_t*)memprof_malloc(MEMPROF_STAGE_RESOLVED, (resolved->node_count + 1) * sizeof(size_t));
+  if ((NULL == resolved->first_edge) || (NULL == resolved->edges) ||
+      (NULL == last_source) || (NULL == last_edge)) {
+    fprintf(stderr, "allocating memory for the resolved network failed\n");
+    memprof_free(MEMPROF_STAGE_RESOLVED, last_source, (resolved->node_count + 1) * sizeof(size_t));
+    memprof_free(MEMPROF_STAGE_RESOLVED, last_edge, (resolved->node_count + 1) * sizeof(size_t));
+    resolved_network_free(resolved);
+    return NULL;
+  }
+  for (i = 0; i < resolved->node_count; i++) {
+    last_source[i] = RESOLVED_NONE;
+  }
+
+  // probe side of the join: neighbour ID -> compact link
+  resolved->edge_count = 0;
+  for (i = 0; i < resolved->node_count; i++) {
+    resolved->first_edge[i] = resolved->edge_count;
+    neighbour = (SRP_NetworkNode_t*)resolved->nodes[i]->neighbours;
+    for (; NULL != neighbour; neighbour = next_neighbour) {
+      next_neighbour = (SRP_NetworkNode_t*)neighbour->neighbours;
+      target = resolved_network_find(resolved, neighbour->id);
+      if (RESOLVED_NONE == target) {
+        if (!(flags & RESOLVE_SKIP_DANGLING) && !resolved_network_add_dangling(resolved, neighbour->id)) {
+          memprof_free(MEMPROF_STAGE_RESOLVED, last_source, (resolved->node_count + 1) * sizeof(size_t));
+          memprof_free(MEMPROF_STAGE_RESOLVED, last_edge, (resolved->node_count + 1) * sizeof(size_t));
+          resolved_network_free(resolved);
+          return NULL;
+        }
+      } else if (i == last_source[target]) {
+        // duplicate link: keep the cheaper one
+        if (neighbour->weight < resolved->edges[last_edge[target]].weight) {
+          resolved->edges[last_edge[target]].weight = neighbour->weight;
+        }
+      } else {
+        last_source[target] = i;
+        last_edge[target] = resolved->edge_count;
+        resolved->edges[resolved->edge_count].target = target;
+        resolved->edges[resolved->edge_count].weight = neighbour->weight;
+        resolved->edge_count++;
+      }
+      if (flags & RESOLVE_RELEASE_NEIGHBOURS) {
+        // keep the chain intact for free_network() in case a later step fails
+        resolved->nodes[i]->neighbours = (struct SRP_NetworkNode_t*)next_neighbour;
+        memprof_free(MEMPROF_STAGE_NEIGHBOURS, neighbour, sizeof(SRP_NetworkNode_t));
+      }
+    }
+  }
+  resolved->first_edge[resolved->node_count] = resolved->edge_count;
+  memprof_free(MEMPROF_STAGE_RESOLVED, last_source, (resolved->node_count + 1) * sizeof(size_t));
+  memprof_free(MEMPROF_STAGE_RESOLVED, last_edge, (resolved->node_count + 1) * sizeof(size_t));
+  resolved_network_unique_dangling(resolved);
+
+  return resolved;
+}
+
+
+/*
+ * Release a resolved network (but not the nodes it refers to).
+ * @param resolved network to be released (may be NULL)
+ */
+void resolved_network_free(resolved_network_t *resolved) {
+  if (NULL == resolved) {
+    return;
+  }
+  memprof_free(MEMPROF_STAGE_RESOLVED, resolved->nodes, (resolved->node_count + 1) * sizeof(SRP_NetworkNode_t*));
+  memprof_free(MEMPROF_STAGE_RESOLVED, resolved->first_edge, (resolved->node_count + 1) * sizeof(size_t));
+  memprof_free(MEMPROF_STAGE_RESOLVED, resolved->edges, resolved->edge_capacity * sizeof(network_edge_t));
+  node_index_free(&resolved->index);
+  memprof_free(MEMPROF_STAGE_RESOLVED, resolved->dangling, resolved->dangling_capacity * sizeof(long long));
+  memprof_free(MEMPROF_STAGE_RESOLVED, resolved, sizeof(resolved_network_t));
+}
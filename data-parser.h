@@ -13,6 +13,47 @@
 	#include "srp_datatypes.h"
 #endif
 
+#ifndef DATA_PARSER_H_
+#define DATA_PARSER_H_
+
+#define RESOLVED_NONE ((size_t)-1) //< index of nodes not found in a resolved network
+#define RESOLVE_RELEASE_NEIGHBOURS 1 //< resolve_network(): free the neighbour entries of every node
+#define RESOLVE_SKIP_DANGLING 2      //< resolve_network(): do not collect references to missing nodes
+
+/**
+ * Hash index mapping node IDs to the positions of the nodes in an array.
+ */
+typedef struct {
+  long long *ids;        //< node ID of every bucket
+  size_t *positions;     //< position of the node of every bucket, RESOLVED_NONE if empty
+  size_t bucket_count;   //< size of the hash table (power of two)
+} node_index_t;
+
+/**
+ * Compact neighbour link of a resolved network.
+ */
+typedef struct {
+  size_t target;     //< index of the neighbour in resolved_network_t.nodes
+  long long weight;  //< weight of the link
+} network_edge_t;
+
+/**
+ * Network with all neighbour references resolved into compact links.
+ * The outgoing links of node i are edges[first_edge[i]] to edges[first_edge[i + 1] - 1].
+ */
+typedef struct {
+  SRP_NetworkNode_t **nodes;  //< all nodes of the network, in list order
+  size_t node_count;          //< number of nodes
+  size_t *first_edge;         //< index of the first link of every node (node_count + 1 entries)
+  network_edge_t *edges;      //< all links, grouped by source node
+  size_t edge_count;          //< number of links
+  size_t edge_capacity;       //< allocated entries of "edges"
+  node_index_t index;         //< node ID -> index in "nodes"
+  long long *dangling;        //< IDs of referenced but missing nodes, sorted
+  size_t dangling_count;      //< number of missing nodes
+  size_t dangling_capacity;   //< allocated entries of "dangling"
+} resolved_network_t;
+
 /**
  * Return JSON node "nodes" from given file
  * @param filename of file to be parsed
@@ -38,6 +79,75 @@ SRP_NetworkNode_t* jsonNode_to_SRP_NetworkNode(json_t *node);
 SRP_Network_t* json_data_to_network(json_t *nodes);
 
 
+/**
+ * Release a network created by json_data_to_network(), including its nodes and their neighbour entries.
+ * @param network to be released (may be NULL)
+ */
+void free_network(SRP_Network_t *network);
+
+
+/**
+ * Comparison function for sorting node IDs (of type long long) with qsort() / bsearch()
+ * @returns negative, zero or positive if "a" is less than, equal to or greater than "b"
+ */
+int compare_ids(const void *a, const void *b);
+
+/**
+ * Release a route and all of its hops.
+ * @param route to be released (may be NULL)
+ */
+void free_route(SRP_node_list_t *route);
+
+
+/**
+ * @brief Prepare an empty node index for up to "node_count" nodes.
+ * The index is the build side of the joins turning neighbour IDs into node positions;
+ * every router resolving IDs shares it.
+ * @param index to be prepared
+ * @param node_count maximum number of nodes to be inserted
+ * @returns 1 in case of success, 0 otherwise
+ * @see node_index_free(node_index_t *index)
+ */
+int node_index_init(node_index_t *index, size_t node_count);
+
+/**
+ * Insert a node into a node index.
+ * @param index to insert into
+ * @param id of the node
+ * @param position of the node in its array (must not be RESOLVED_NONE)
+ * @returns 1 in case of success, 0 if the ID is already present
+ */
+int node_index_insert(node_index_t *index, long long id, size_t position);
+
+/**
+ * Find a node in a node index.
+ * @param index to be searched
+ * @param id of the node
+ * @returns position of the node in case of success, RESOLVED_NONE otherwise
+ */
+size_t node_index_find(const node_index_t *index, long long id);
+
+/**
+ * Release the tables of a node index (the index itself is not freed).
+ * @param index to be released
+ */
+void node_index_free(node_index_t *index);
+
+/**
+ * Sort a list of IDs and remove duplicates.
+ * @param ids to be sorted
+ * @param count number of IDs
+ * @returns the new number of IDs
+ */
+size_t sort_unique_ids(long long *ids, size_t count);
+
+/**
+ * Report the IDs of referenced but missing nodes on one line.
+ * @param ids of the missing nodes (as returned by sort_unique_ids())
+ * @param count number of missing nodes, nothing is reported for 0
+ */
+void report_dangling_references(const long long *ids, size_t count);
+
 /**
  * Convert JSON object to routing criterion.
  * @param json points to the JSON object to be converted
@@ -56,6 +166,20 @@ SRP_RoutingCriterion_t* json_to_routing_criterion(json_t *json);
 SRP_ObjectiveFunction_t* extract_objective_functions(const char* filename);
 
 
+/**
+ * @brief Check whether a JSON network node fulfils the node criteria of an objective function.
+ * The metric "owner" refers to the "node owner" of the node, "node energy" to the "level" of
+ * its "node energy" and any other metric to the numeric attribute of the same name.
+ * The link metrics "latency" and "throughput" are not node criteria and therefore not checked.
+ * A node lacking the attribute of a node criterion does not fulfil it.
+ *
+ * @param node from the JSON data-structure
+ * @param of objective function to be checked (NULL is fulfilled by every node)
+ * @param skip_energy skips "node energy" criteria if non-zero (for callers checking them along the path)
+ * @returns 1 if the node fulfils all node criteria, 0 otherwise
+ */
+int json_node_fulfils_objective_function(json_t *node, SRP_ObjectiveFunction_t *of, int skip_energy);
+
 /**
  * @brief Filter a given network according to a given objective function.
  * This function reduces the network to all the nodes fullfilling the conditions
@@ -81,3 +205,47 @@ SRP_Network_t* filter_network(SRP_Network_t* network, char* criteria);
  * @return 1 in case of success, 0 in case of any errors
  */
 int write_route_to_JSON_file(const char *filename, int route_id, SRP_node_list_t *route);
+
+
+/**
+ * @brief Check the neighbour references of a converted network without resolving them.
+ * Only the node index is built; "first_edge" and "edges" stay NULL and "edge_count"
+ * holds the number of neighbour references (duplicates included).
+ * References to missing nodes are collected in "dangling".
+ *
+ * @param network to be checked (as returned by json_data_to_network())
+ * @returns resolved_network_t pointer in case of success, NULL otherwise
+ * @see resolved_network_free(resolved_network_t *resolved)
+ */
+resolved_network_t* check_network_references(SRP_Network_t *network);
+
+/**
+ * @brief Resolve the neighbour references of a converted network.
+ * A single hash join turns the neighbour IDs of every node into the index of the
+ * referenced node. Links are stored as compact (target, weight) records; duplicate
+ * links between the same pair of nodes are merged, keeping the smallest weight.
+ * References to missing nodes are skipped and collected in "dangling", unless
+ * RESOLVE_SKIP_DANGLING is given.
+ *
+ * @param network to be resolved (as returned by json_data_to_network())
+ * @param flags RESOLVE_RELEASE_NEIGHBOURS and/or RESOLVE_SKIP_DANGLING, 0 for none
+ * @returns resolved_network_t pointer in case of success, NULL otherwise
+ * @see resolved_network_find(resolved_network_t *resolved, long long id)
+ */
+resolved_network_t* resolve_network(SRP_Network_t *network, int flags);
+
+/**
+ * Find a node of a resolved network by its ID.
+ * @param resolved network to be searched
+ * @param id of the node
+ * @returns index of the node in case of success, RESOLVED_NONE otherwise
+ */
+size_t resolved_network_find(resolved_network_t *resolved, long long id);
+
+/**
+ * Release a resolved network (but not the nodes it refers to).
+ * @param resolved network to be released (may be NULL)
+ */
+void resolved_network_free(resolved_network_t *resolved);
+
+#endif
@@ -6,6 +6,7 @@
  * This file is licensed under APGL(v3) or later.
  */
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <jansson.h>
 #include "SRP/srp.h"
@@ -13,6 +14,29 @@
 	#include "srp_datatypes.h"
 #endif
 #include "data-parser.h"
+#include "pareto-router.h"
+#include "shard-router.h"
+#include "memprof.h"
+
+/*
+ * Write the profiling report (if profiling) and turn an exceeded memory budget into an error.
+ * @param report filename of the profiling report, NULL if not profiling
+ * @param status exit status so far
+ * @returns exit status to be used
+ */
+static int finish_profiling(const char *report, int status) {
+  if (NULL == report) {
+    return status;
+  }
+  if (1 != memprof_write_report(report)) {
+    return (0 == status) ? 8 : status;
+  }
+  if (memprof_budget_exceeded()) {
+    fprintf(stderr, "conversion aborted: memory budget exceeded (see \"%s\")\n", report);
+    return 7;
+  }
+  return status;
+}
 
 
 int main(int argc, char* argv[]){
@@ -21,29 +45,158 @@ int main(int argc, char* argv[]){
   SRP_ObjectiveFunction_t *of = NULL;	//< objective function / routing criteria
   SRP_node_list_t *path = NULL;			//< path from start to finish
   SRP_node_list_element_t *hop = NULL;	//< path from start to finish
+  pareto_graph_t *graph = NULL;			//< network annotated with routing metrics
+  pareto_path_t *pareto_paths = NULL;	//< Pareto-optimal paths from start to finish
+  pareto_path_t *pareto_path = NULL;	//< current/chosen Pareto-optimal path
+  shard_network_t *shards = NULL;		//< network distributed over worker processes
+  size_t shard_count = 0;				//< number of shards (0: one shard per node owner)
+  long long distance = 0;				//< length of the calculated path
+  char *end = NULL;						//< end of a parsed number
+  resolved_network_t *resolved = NULL;	//< node index with the dangling neighbour references
+  const char *report = NULL;			//< profiling report file, NULL if not profiling
+  size_t budget = 0;					//< memory budget for profiling (0: unlimited)
+  int status = 0;						//< exit status of the profiling report
 
   // check for correct number of arguments
-  if (2 != argc) {
+  if ((2 > argc) || (5 < argc)) {
     fprintf(stderr, "invalid number of arguments given\n");
-    fprintf(stdout, "usage: %s <network data JSON file>\n", argv[0]);
+    fprintf(stdout, "usage: %s <network data JSON file> [pareto | sharded [<number of shards>] "
+            "| profile <report file> [<memory budget in bytes>]]\n", argv[0]);
+    fprintf(stdout, "note: sharded mode routes on the neighbour weights as given; the weight adjustment "
+            "of the default mode (SRP_adjust_Network()) is not applied, so routes may differ\n");
+    return 1;
+  }
+  if ((3 <= argc) && (0 == strcmp("pareto", argv[2]))) {
+    if (3 != argc) {
+      fprintf(stderr, "invalid number of arguments given\n");
+      return 1;
+    }
+  } else if ((3 <= argc) && (0 == strcmp("sharded", argv[2]))) {
+    if (5 == argc) {
+      fprintf(stderr, "invalid number of arguments given\n");
+      return 1;
+    }
+    if (4 == argc) {
+      shard_count = (size_t)strtoul(argv[3], &end, 10);
+      if ((end == argv[3]) || ('\0' != *end) || (0 == shard_count)) {
+        fprintf(stderr, "invalid number of shards \"%s\"\n", argv[3]);
+        return 1;
+      }
+    }
+  } else if ((3 <= argc) && (0 == strcmp("profile", argv[2]))) {
+    if (3 == argc) {
+      fprintf(stderr, "no profiling report file given\n");
+      return 1;
+    }
+    report = argv[3];
+    if (5 == argc) {
+      budget = (size_t)strtoull(argv[4], &end, 10);
+      if ((end == argv[4]) || ('\0' != *end) || (0 == budget)) {
+        fprintf(stderr, "invalid memory budget \"%s\"\n", argv[4]);
+        return 1;
+      }
+    }
+    // must happen before jansson allocates anything
+    memprof_enable(budget);
+  } else if (3 <= argc) {
+    fprintf(stderr, "unknown mode \"%s\"\n", argv[2]);
+    return 1;
   }
 
   //@todo sanity checks for argv[1]
   nodes = get_nodes(argv[1]);
   if (!nodes) {
     fprintf(stderr, "extracting nodes failed\n");
-    return 1;
+    return finish_profiling(report, 1);
+  }
+
+  // multi-criteria mode: compute all trade-offs in one search, let the objective function choose
+  if ((3 <= argc) && (0 == strcmp("pareto", argv[2]))) {
+    of = extract_objective_functions(argv[1]);
+    if (NULL == of) {
+      return 3;
+    }
+    graph = json_data_to_pareto_graph(nodes, of);
+    if (NULL == graph) {
+      return 2;
+    }
+    pareto_paths = pareto_route(graph, 23, 42, PARETO_METRIC_COUNT, PARETO_DEFAULT_MAX_LABELS);
+    if (NULL == pareto_paths) {
+      return 5;
+    }
+    for (pareto_path = pareto_paths; NULL != pareto_path; pareto_path = pareto_path->next) {
+      fprintf(stdout, "Pareto-optimal route (latency %g, throughput %g, node energy %g): ",
+              pareto_path->cost[PARETO_METRIC_LATENCY],
+              pareto_path->cost[PARETO_METRIC_THROUGHPUT],
+              pareto_path->cost[PARETO_METRIC_ENERGY]);
+      for (hop = pareto_path->route->start; NULL != hop->next; hop = (SRP_node_list_element_t*)hop->next) {
+        fprintf(stdout, "%llu --> ", hop->id);
+      }
+      fprintf(stdout, "%llu\n", hop->id);
+    }
+    pareto_path = pareto_select(pareto_paths, of);
+    if (NULL == pareto_path) {
+      fprintf(stderr, "no route fulfils the objective function\n");
+      return 5;
+    }
+    if (1 != write_route_to_JSON_file(argv[1], 23234242, pareto_path->route)){
+      return 6;
+    }
+    pareto_paths_free(pareto_paths);
+    pareto_graph_free(graph);
+    return 0;
+  }
+
+  // sharded mode: shards are converted and searched by worker processes, routed across by this process;
+  // the objective function selects the nodes, link weights are used as given (no SRP_adjust_Network())
+  if ((3 <= argc) && (0 == strcmp("sharded", argv[2]))) {
+    of = extract_objective_functions(argv[1]);
+    if (NULL == of) {
+      return 3;
+    }
+    shards = shard_network_start(nodes, of, (0 == shard_count) ? SHARD_BY_OWNER : SHARD_BY_PARTITIONER, shard_count);
+    if (NULL == shards) {
+      return 2;
+    }
+    path = shard_route(shards, 23, 42, &distance);
+    if (NULL == path) {
+      shard_network_shutdown(shards);
+      return 5;
+    }
+    fprintf(stdout, "calculated route (length %lli): ", distance);
+    for (hop = path->start; NULL != hop->next; hop = (SRP_node_list_element_t*)hop->next) {
+      fprintf(stdout, "%llu --> ", hop->id);
+    }
+    fprintf(stdout, "%llu\n", hop->id);
+    shard_network_shutdown(shards);
+    if (1 != write_route_to_JSON_file(argv[1], 23234242, path)){
+      return 6;
+    }
+    return 0;
   }
 
   network = json_data_to_network(nodes);
   if (NULL == network) {
-    return 2;
+    return finish_profiling(report, 2);
+  }
+
+  // check neighbour references (SRP_route() works on the neighbour entries, so no links are built)
+  resolved = check_network_references(network);
+  if (NULL == resolved) {
+    return finish_profiling(report, 2);
   }
+  report_dangling_references(resolved->dangling, resolved->dangling_count);
+  fprintf(stdout, "%zu nodes, %zu neighbour references\n", resolved->node_count, resolved->edge_count);
+  resolved_network_free(resolved);
 
   //@todo sanity checks for argv[1]
   of = extract_objective_functions(argv[1]);
   if (NULL == of) {
-	  return 3;
+	  return finish_profiling(report, 3);
+  }
+  status = finish_profiling(report, 0);
+  if (0 != status) {
+	  return status;
   }
 
   // adjust weight according to objective function
@@ -0,0 +1,346 @@
+/* Allocation profiling for the SRP conversion pipeline
+ *
+ * Attributes allocation counts, bytes and peak live memory to the stages
+ * of the conversion pipeline and enforces an optional memory budget.
+ * This file is licensed under APGL(v3) or later.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <jansson.h>
+#include "SRP/srp.h"
+#ifndef SRPDATATYPES_H_
+	#include "srp_datatypes.h"
+#endif
+#include "memprof.h"
+
+/*
+ * Counters of one stage.
+ */
+typedef struct {
+  size_t allocations;  //< number of allocations
+  size_t releases;     //< number of releases
+  size_t bytes;        //< bytes allocated in total
+  size_t live;         //< bytes currently allocated
+  size_t peak;         //< largest value of "live"
+} memprof_counter_t;
+
+/*
+ * Size prefix of jansson allocations (padded to keep the payload aligned).
+ */
+typedef union {
+  struct {
+    size_t size;       //< size requested by jansson
+    int stage;         //< stage the allocation is attributed to
+  } block;
+  long double align;   //< alignment of the payload
+} memprof_header_t;
+
+static const char *memprof_stage_names[MEMPROF_STAGE_COUNT] = {
+  "JSON document", "network", "neighbours", "criteria", "resolved network", "objectives JSON"
+};
+
+static int memprof_enabled = 0;                                //< profiling active
+static int memprof_exceeded = 0;                               //< an allocation hit the budget
+static size_t memprof_budget = 0;                              //< live byte limit, 0 for none
+static size_t memprof_live = 0;                                //< live bytes over all stages
+static size_t memprof_peak = 0;                                //< largest value of "memprof_live"
+static memprof_counter_t memprof_counters[MEMPROF_STAGE_COUNT]; //< counters per stage
+static int memprof_json_stage = MEMPROF_STAGE_JSON;            //< stage of jansson allocations
+
+
+/*
+ * Account an allocation, unless it would exceed the budget.
+ * @returns 1 if the allocation may proceed, 0 otherwise
+ */
+static int memprof_account(int stage, size_t size) {
+  memprof_counter_t *counter = &memprof_counters[stage];  //< counters of the stage
+
+  if ((0 != memprof_budget) && (memprof_budget - memprof_live < size)) {
+    if (!memprof_exceeded) {
+      fprintf(stderr, "memory budget of %zu bytes exceeded in stage \"%s\" "
+              "(%zu bytes requested, %zu bytes in use)\n",
+              memprof_budget, memprof_stage_names[stage], size, memprof_live);
+    }
+    memprof_exceeded = 1;
+    return 0;
+  }
+
+  counter->allocations++;
+  counter->bytes += size;
+  counter->live += size;
+  if (counter->live > counter->peak) {
+    counter->peak = counter->live;
+  }
+  memprof_live += size;
+  if (memprof_live > memprof_peak) {
+    memprof_peak = memprof_live;
+  }
+  return 1;
+}
+
+
+/*
+ * Account a release.
+ */
+static void memprof_release(int stage, size_t size) {
+  memprof_counter_t *counter = &memprof_counters[stage];  //< counters of the stage
+
+  counter->releases++;
+  counter->live -= size;
+  memprof_live -= size;
+}
+
+
+/*
+ * Allocation function handed to jansson.
+ */
+static void* memprof_json_malloc(size_t size) {
+  memprof_header_t *header = NULL;  //< size prefix
+  int stage = memprof_json_stage;   //< stage of the allocation
+
+  if (!memprof_account(stage, size)) {
+    return NULL;
+  }
+  header = (memprof_header_t*)malloc(sizeof(memprof_header_t) + size);
+  if (NULL == header) {
+    memprof_release(stage, size);
+    return NULL;
+  }
+  header->block.size = size;
+  header->block.stage = stage;
+  return header + 1;
+}
+
+
+/*
+ * Release function handed to jansson.
+ */
+static void memprof_json_free(void *ptr) {
+  memprof_header_t *header = NULL;  //< size prefix
+
+  if (NULL == ptr) {
+    return;
+  }
+  header = (memprof_header_t*)ptr - 1;
+  memprof_release(header->block.stage, header->block.size);
+  free(header);
+}
+
+
+/*
+ * @brief Start profiling and route all jansson allocations through the profiler.
+ * Must be called before any JSON data is loaded.
+ * @param budget maximum number of live bytes over all stages, 0 for no limit
+ */
+void memprof_enable(size_t budget) {
+  memset(memprof_counters, 0, sizeof(memprof_counters));
+  memprof_live = 0;
+  memprof_peak = 0;
+  memprof_exceeded = 0;
+  memprof_budget = budget;
+  memprof_json_stage = MEMPROF_STAGE_JSON;
+  memprof_enabled = 1;
+  json_set_alloc_funcs(memprof_json_malloc, memprof_json_free);
+}
+
+
+/*
+ * Select the stage jansson allocations are attributed to (MEMPROF_STAGE_JSON by default).
+ * Releases are always attributed to the stage the memory was allocated in.
+ * @param stage one of MEMPROF_STAGE_*
+ * @returns the previously selected stage
+ */
+int memprof_set_json_stage(int stage) {
+  int previous = memprof_json_stage;  //< stage selected so far
+
+  memprof_json_stage = stage;
+  return previous;
+}
+
+
+/*
+ * Allocate memory attributed to a stage (works like malloc()).
+ * @param stage one of MEMPROF_STAGE_*
+ * @param size in bytes
+ * @returns pointer to the memory in case of success, NULL otherwise (including an exceeded budget)
+ */
+void* memprof_malloc(int stage, size_t size) {
+  void *ptr = NULL;  //< allocated memory
+
+  if (!memprof_enabled) {
+    return malloc(size);
+  }
+  if (!memprof_account(stage, size)) {
+    return NULL;
+  }
+  ptr = malloc(size);
+  if (NULL == ptr) {
+    memprof_release(stage, size);
+  }
+  return ptr;
+}
+
+
+/*
+ * Allocate zeroed memory attributed to a stage (works like calloc()).
+ * @param stage one of MEMPROF_STAGE_*
+ * @param count number of elements
+ * @param size of one element in bytes
+ * @returns pointer to the memory in case of success, NULL otherwise (including an exceeded budget)
+ */
+void* memprof_calloc(int stage, size_t count, size_t size) {
+  void *ptr = NULL;  //< allocated memory
+
+  if (!memprof_enabled) {
+    return calloc(count, size);
+  }
+  if ((0 != size) && (count > (size_t)-1 / size)) {
+    return NULL;
+  }
+  if (!memprof_account(stage, count * size)) {
+    return NULL;
+  }
+  ptr = calloc(count, size);
+  if (NULL == ptr) {
+    memprof_release(stage, count * size);
+  }
+  return ptr;
+}
+
+
+/*
+ * Resize memory attributed to a stage (works like realloc()).
+ * While profiling, the data is always moved into a newly allocated block.
+ * @param stage one of MEMPROF_STAGE_*
+ * @param ptr to be resized (may be NULL)
+ * @param old_size the memory was allocated with
+ * @param size in bytes
+ * @returns pointer to the memory in case of success, NULL otherwise (including an exceeded budget)
+ */
+void* memprof_realloc(int stage, void *ptr, size_t old_size, size_t size) {
+  void *resized = NULL;  //< resized memory
+
+  if (!memprof_enabled) {
+    return realloc(ptr, size);
+  }
+  // moving into a new block keeps the counters exact (old and new block are live while copying)
+  resized = memprof_malloc(stage, size);
+  if (NULL == resized) {
+    return NULL;
+  }
+  if (NULL != ptr) {
+    memcpy(resized, ptr, (old_size < size) ? old_size : size);
+    memprof_free(stage, ptr, old_size);
+  }
+  return resized;
+}
+
+
+/*
+ * Release memory attributed to a stage (works like free()).
+ * @param stage one of MEMPROF_STAGE_*
+ * @param ptr to be released (may be NULL)
+ * @param size the memory was allocated with
+ */
+void memprof_free(int stage, void *ptr, size_t size) {
+  if (NULL == ptr) {
+    return;
+  }
+  if (memprof_enabled) {
+    memprof_release(stage, size);
+  }
+  free(ptr);
+}
+
+
+/*
+ * Create a network list element via SRP_Network_create(), attributed to MEMPROF_STAGE_NETWORK.
+ * @returns SRP_Network_t pointer in case of success, NULL otherwise (including an exceeded budget)
+ */
+SRP_Network_t* memprof_SRP_Network_create(void) {
+  SRP_Network_t *element = NULL;  //< created element
+
+  if (!memprof_enabled) {
+    return SRP_Network_create();
+  }
+  if (!memprof_account(MEMPROF_STAGE_NETWORK, sizeof(SRP_Network_t))) {
+    return NULL;
+  }
+  element = SRP_Network_create();
+  if (NULL == element) {
+    memprof_release(MEMPROF_STAGE_NETWORK, sizeof(SRP_Network_t));
+  }
+  return element;
+}
+
+
+/*
+ * Create a network node via SRP_NetworkNode_create().
+ * @param stage MEMPROF_STAGE_NETWORK for nodes, MEMPROF_STAGE_NEIGHBOURS for neighbour entries
+ * @returns SRP_NetworkNode_t pointer in case of success, NULL otherwise (including an exceeded budget)
+ */
+SRP_NetworkNode_t* memprof_SRP_NetworkNode_create(int stage) {
+  SRP_NetworkNode_t *node = NULL;  //< created node
+
+  if (!memprof_enabled) {
+    return SRP_NetworkNode_create();
+  }
+  if (!memprof_account(stage, sizeof(SRP_NetworkNode_t))) {
+    return NULL;
+  }
+  node = SRP_NetworkNode_create();
+  if (NULL == node) {
+    memprof_release(stage, sizeof(SRP_NetworkNode_t));
+  }
+  return node;
+}
+
+
+/*
+ * Check whether an allocation failed because of the memory budget.
+ * @returns 1 if the budget was exceeded, 0 otherwise
+ */
+int memprof_budget_exceeded(void) {
+  return memprof_exceeded;
+}
+
+
+/*
+ * Write allocation counts, bytes and peak live memory of every stage.
+ * @param filename of the report to be written
+ * @return 1 in case of success, 0 in case of any errors
+ */
+int memprof_write_report(const char *filename) {
+  FILE *report = NULL;  //< report file
+  int stage = 0;        //< current stage
+
+  if (NULL == filename) {
+    return 0;
+  }
+  report = fopen(filename, "w");
+  if (NULL == report) {
+    fprintf(stderr, "opening the profiling report \"%s\" failed\n", filename);
+    return 0;
+  }
+
+  fprintf(report, "%-16s %12s %12s %14s %14s %14s\n",
+          "stage", "allocations", "releases", "bytes", "live bytes", "peak bytes");
+  for (stage = 0; stage < MEMPROF_STAGE_COUNT; stage++) {
+    fprintf(report, "%-16s %12zu %12zu %14zu %14zu %14zu\n", memprof_stage_names[stage],
+            memprof_counters[stage].allocations, memprof_counters[stage].releases,
+            memprof_counters[stage].bytes, memprof_counters[stage].live, memprof_counters[stage].peak);
+  }
+  fprintf(report, "peak live bytes over all stages: %zu\n", memprof_peak);
+  if (0 != memprof_budget) {
+    fprintf(report, "memory budget: %zu bytes%s\n", memprof_budget,
+            memprof_exceeded ? " (exceeded)" : "");
+  }
+  fprintf(report, "note: sizes are the requested sizes, allocator overhead is not included\n");
+
+  if (0 != fclose(report)) {
+    fprintf(stderr, "writing the profiling report \"%s\" failed\n", filename);
+    return 0;
+  }
+  return 1;
+}
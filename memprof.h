@@ -0,0 +1,104 @@
+/* Allocation profiling for the SRP conversion pipeline
+ *
+ * Attributes allocation counts, bytes and peak live memory to the stages
+ * of the conversion pipeline and enforces an optional memory budget.
+ * This file is licensed under APGL(v3) or later.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <jansson.h>
+#include "SRP/srp.h"
+#ifndef SRPDATATYPES_H_
+	#include "srp_datatypes.h"
+#endif
+
+#ifndef MEMPROF_H_
+#define MEMPROF_H_
+
+#define MEMPROF_STAGE_JSON 0            //< jansson document trees
+#define MEMPROF_STAGE_NETWORK 1         //< SRP_Network_t list and its nodes
+#define MEMPROF_STAGE_NEIGHBOURS 2      //< neighbour entries of the nodes
+#define MEMPROF_STAGE_CRITERIA 3        //< objective functions and routing criteria
+#define MEMPROF_STAGE_RESOLVED 4        //< node index and compact links of resolved networks
+#define MEMPROF_STAGE_OBJECTIVES_JSON 5 //< jansson document the objective functions are read from
+#define MEMPROF_STAGE_COUNT 6           //< number of stages
+
+
+/**
+ * @brief Start profiling and route all jansson allocations through the profiler.
+ * Must be called before any JSON data is loaded.
+ * @param budget maximum number of live bytes over all stages, 0 for no limit
+ */
+void memprof_enable(size_t budget);
+
+/**
+ * Select the stage jansson allocations are attributed to (MEMPROF_STAGE_JSON by default).
+ * Releases are always attributed to the stage the memory was allocated in.
+ * @param stage one of MEMPROF_STAGE_*
+ * @returns the previously selected stage
+ */
+int memprof_set_json_stage(int stage);
+
+/**
+ * Allocate memory attributed to a stage (works like malloc()).
+ * @param stage one of MEMPROF_STAGE_*
+ * @param size in bytes
+ * @returns pointer to the memory in case of success, NULL otherwise (including an exceeded budget)
+ */
+void* memprof_malloc(int stage, size_t size);
+
+/**
+ * Allocate zeroed memory attributed to a stage (works like calloc()).
+ * @param stage one of MEMPROF_STAGE_*
+ * @param count number of elements
+ * @param size of one element in bytes
+ * @returns pointer to the memory in case of success, NULL otherwise (including an exceeded budget)
+ */
+void* memprof_calloc(int stage, size_t count, size_t size);
+
+/**
+ * Resize memory attributed to a stage (works like realloc()).
+ * While profiling, the data is always moved into a newly allocated block.
+ * @param stage one of MEMPROF_STAGE_*
+ * @param ptr to be resized (may be NULL)
+ * @param old_size the memory was allocated with
+ * @param size in bytes
+ * @returns pointer to the memory in case of success, NULL otherwise (including an exceeded budget)
+ */
+void* memprof_realloc(int stage, void *ptr, size_t old_size, size_t size);
+
+/**
+ * Release memory attributed to a stage (works like free()).
+ * @param stage one of MEMPROF_STAGE_*
+ * @param ptr to be released (may be NULL)
+ * @param size the memory was allocated with
+ */
+void memprof_free(int stage, void *ptr, size_t size);
+
+/**
+ * Create a network list element via SRP_Network_create(), attributed to MEMPROF_STAGE_NETWORK.
+ * @returns SRP_Network_t pointer in case of success, NULL otherwise (including an exceeded budget)
+ */
+SRP_Network_t* memprof_SRP_Network_create(void);
+
+/**
+ * Create a network node via SRP_NetworkNode_create().
+ * @param stage MEMPROF_STAGE_NETWORK for nodes, MEMPROF_STAGE_NEIGHBOURS for neighbour entries
+ * @returns SRP_NetworkNode_t pointer in case of success, NULL otherwise (including an exceeded budget)
+ */
+SRP_NetworkNode_t* memprof_SRP_NetworkNode_create(int stage);
+
+/**
+ * Check whether an allocation failed because of the memory budget.
+ * @returns 1 if the budget was exceeded, 0 otherwise
+ */
+int memprof_budget_exceeded(void);
+
+/**
+ * Write allocation counts, bytes and peak live memory of every stage.
+ * @param filename of the report to be written
+ * @return 1 in case of success, 0 in case of any errors
+ */
+int memprof_write_report(const char *filename);
+
+#endif
@@ -0,0 +1,732 @@
+/* Multi-criteria (Pareto) router for SRP network data
+ *
+ * This router computes the set of Pareto-optimal paths between two
+ * nodes for up to three metrics in a single label-correcting search.
+ * An objective function picks one path from that set afterwards.
+ * This file is licensed under APGL(v3) or later.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <jansson.h>
+#include "SRP/srp.h"
+#ifndef SRPDATATYPES_H_
+	#include "srp_datatypes.h"
+#endif
+#include "data-parser.h"
+#include "pareto-router.h"
+
+#define PARETO_EXCLUDED ((size_t)-2) //< node index position of nodes left out by the objective function
+
+/*
+ * Search label: the metric values of one partial path ending at a node.
+ */
+typedef struct {
+  size_t node;                       //< index of the node the label belongs to
+  double cost[PARETO_METRIC_COUNT];  //< metric values of the partial path
+  size_t pred;                       //< index of the predecessor label (itself for the start label)
+  int alive;                         //< 0 once the label got dominated
+} pareto_label_t;
+
+/*
+ * Set of non-dominated labels at one node.
+ */
+typedef struct {
+  size_t *labels;  //< indices into the label pool
+  size_t size;     //< number of used entries
+  size_t capacity; //< number of allocated entries
+} pareto_bag_t;
+
+
+/*
+ * Find a node by its ID.
+ * @param graph to be searched
+ * @param id of the node
+ * @returns pointer to the node in case of success, NULL otherwise
+ */
+static pareto_node_t* pareto_find_node(pareto_graph_t *graph, long long id) {
+  size_t position = 0;  //< position of the node in the node array
+
+  position = node_index_find(&graph->index, id);
+  if ((RESOLVED_NONE == position) || (PARETO_EXCLUDED == position)) {
+    return NULL;
+  }
+  return &graph->nodes[position];
+}
+
+
+/*
+ * Check whether edge "a" is at least as good as edge "b" in latency and throughput.
+ * @returns 1 if "a" weakly dominates "b", 0 otherwise
+ */
+static int pareto_edge_dominates(const pareto_edge_t *a, const pareto_edge_t *b) {
+  return (a->latency <= b->latency) && (a->throughput >= b->throughput);
+}
+
+
+/*
+ * Read an optional number from a JSON object.
+ * @param object to read from
+ * @param key of the number
+ * @param fallback to be returned in case the key is missing or not a number
+ * @returns the number in case of success, "fallback" otherwise
+ */
+static double pareto_get_number(json_t *object, const char *key, double fallback) {
+  json_t *element_ptr = NULL;  //< value associated with the key
+
+  element_ptr = json_object_get(object, key);
+  if (NULL == element_ptr) {
+    return fallback;
+  }
+  if (!json_is_number(element_ptr)) {
+    return fallback;
+  }
+  return json_number_value(element_ptr);
+}
+
+
+/*
+ * Convert JSON-nodes data to a graph annotated with routing metrics.
+ * Nodes not fulfilling the node criteria of the objective function (see
+ * json_node_fulfils_objective_function()) are left out, together with all edges
+ * leading to them. "node energy" criteria are not applied to single nodes: they
+ * are path constraints checked by pareto_select(). Missing metrics fall back to
+ * neutral values: latency defaults to 0 (with a warning), throughput to unlimited
+ * and the energy level to 1.0.
+ * Neighbour IDs are resolved through the shared node index. Duplicate links between
+ * the same pair of nodes are merged into the better one (kept apart if neither is
+ * better in both latency and throughput), and neighbours referring to unknown nodes
+ * are skipped and reported once.
+ * @param nodes to be parsed (as returned by get_nodes())
+ * @param of objective function selecting the nodes to route over (may be NULL)
+ * @returns pareto_graph_t pointer in case of success, NULL otherwise
+ * @see pareto_graph_free(pareto_graph_t *graph)
+ */
+pareto_graph_t* json_data_to_pareto_graph(json_t *nodes, SRP_ObjectiveFunction_t *of) {
+  pareto_graph_t *graph = NULL;     //< graph to be constructed
+  pareto_node_t *graph_node = NULL; //< current node in the graph
+  pareto_edge_t edge;               //< current edge to be added
+  pareto_edge_t *merged = NULL;     //< earlier edge between the same nodes
+  json_t *node_ptr = NULL;          //< current JSON node
+  json_t *neighbours = NULL;        //< neighbour array of the current JSON node
+  json_t *neighbour_ptr = NULL;     //< current neighbour from array
+  json_t *element_ptr = NULL;       //< current JSON element
+  size_t node_index = 0;            //< index in the node array
+  size_t neighbour_index = 0;       //< index in the neighbour array
+  size_t edge_total = 0;            //< upper bound of the number of edges
+  size_t position = 0;              //< position of a node in the graph, PARETO_EXCLUDED or RESOLVED_NONE
+  size_t source = 0;                //< position of the current node
+  size_t *last_source = NULL;       //< last node linking to every node (for merging duplicates)
+  size_t *last_edge = NULL;         //< edge created by that node
+  long long *dangling = NULL;       //< IDs of referenced but missing nodes
+  size_t dangling_count = 0;        //< number of missing references
+  size_t missing_latency = 0;       //< number of edges without "latency"
+
+  // sanity checks
+  if (NULL == nodes) {
+    return NULL;
+  }
+  if (!json_is_array(nodes)) {
+    return NULL;
+  }
+  if (0 == json_array_size(nodes)) {
+    return NULL;
+  }
+
+  graph = (pareto_graph_t*)calloc(1, sizeof(pareto_graph_t));
+  if (NULL == graph) {
+    fprintf(stderr, "allocating memory for the graph failed\n");
+    return NULL;
+  }
+  graph->nodes = (pareto_node_t*)calloc(json_array_size(nodes), sizeof(pareto_node_t));
+  if (NULL == graph->nodes) {
+    fprintf(stderr, "allocating memory for the graph nodes failed\n");
+    pareto_graph_free(graph);
+    return NULL;
+  }
+  if (!node_index_init(&graph->index, json_array_size(nodes))) {
+    pareto_graph_free(graph);
+    return NULL;
+  }
+
+  // first pass: collect nodes into the build side of the join and count neighbours
+  json_array_foreach(nodes, node_index, node_ptr) {
+    if (!json_is_object(node_ptr)) {
+      fprintf(stderr, "node %zu not encoded as JSON object\n", node_index);
+      pareto_graph_free(graph);
+      return NULL;
+    }
+    element_ptr = json_object_get(node_ptr, "node id");
+    if (!json_is_number(element_ptr)) {
+      fprintf(stderr, "node %zu has no valid \"node id\"\n", node_index);
+      pareto_graph_free(graph);
+      return NULL;
+    }
+    // excluded nodes stay in the index so links to them are not reported as dangling
+    position = json_node_fulfils_objective_function(node_ptr, of, 1) ? graph->node_count : PARETO_EXCLUDED;
+    if (!node_index_insert(&graph->index, json_integer_value(element_ptr), position)) {
+      fprintf(stderr, "node %lli defined more than once\n", json_integer_value(element_ptr));
+      pareto_graph_free(graph);
+      return NULL;
+    }
+    if (PARETO_EXCLUDED == position) {
+      continue;
+    }
+    graph_node = &graph->nodes[graph->node_count];
+    graph_node->id = json_integer_value(element_ptr);
+    graph_node->energy = 1.0;
+    element_ptr = json_object_get(node_ptr, "node energy");
+    if (json_is_object(element_ptr)) {
+      graph_node->energy = pareto_get_number(element_ptr, "level", 1.0);
+    }
+    graph->node_count++;
+
+    neighbours = json_object_get(node_ptr, "neighbours");
+    if (json_is_array(neighbours)) {
+      edge_total += json_array_size(neighbours);
+    }
+  }
+
+  if (0 == graph->node_count) {
+    fprintf(stderr, "no node fulfils the objective function\n");
+    pareto_graph_free(graph);
+    return NULL;
+  }
+
+  graph->edges = (pareto_edge_t*)calloc(edge_total + 1, sizeof(pareto_edge_t));
+  dangling = (long long*)malloc((edge_total + 1) * sizeof(long long));
+  last_source = (size_t*)malloc(graph->node_count * sizeof(size_t));
+  last_edge = (size_t*)malloc(graph->node_count * sizeof(size_t));
+  if ((NULL == graph->edges) || (NULL == dangling) || (NULL == last_source) || (NULL == last_edge)) {
+    fprintf(stderr, "allocating memory for the graph edges failed\n");
+    free(dangling);
+    free(last_source);
+    free(last_edge);
+    pareto_graph_free(graph);
+    return NULL;
+  }
+  for (source = 0; source < graph->node_count; source++) {
+    last_source[source] = RESOLVED_NONE;
+  }
+
+  // second pass (probe side of the join): neighbours -> edges, grouped by source node
+  json_array_foreach(nodes, node_index, node_ptr) {
+    source = node_index_find(&graph->index, json_integer_value(json_object_get(node_ptr, "node id")));
+    if (PARETO_EXCLUDED == source) {
+      continue;
+    }
+    graph_node = &graph->nodes[source];
+    graph_node->first_edge = graph->edge_count;
+
+    neighbours = json_object_get(node_ptr, "neighbours");
+    if (!json_is_array(neighbours)) {
+      continue;
+    }
+    json_array_foreach(neighbours, neighbour_index, neighbour_ptr) {
+      if (!json_is_object(neighbour_ptr)) {
+        fprintf(stderr, "neighbour %zu of node %lli not encoded as JSON object\n",
+                neighbour_index, graph_node->id);
+        continue;
+      }
+      element_ptr = json_object_get(neighbour_ptr, "node id");
+      if (!json_is_number(element_ptr)) {
+        fprintf(stderr, "neighbour %zu of node %lli has no valid \"node id\"\n",
+                neighbour_index, graph_node->id);
+        continue;
+      }
+      position = node_index_find(&graph->index, json_integer_value(element_ptr));
+      if (PARETO_EXCLUDED == position) {
+        continue;
+      }
+      if (RESOLVED_NONE == position) {
+        dangling[dangling_count++] = json_integer_value(element_ptr);
+        continue;
+      }
+
+      edge.target = position;
+      if (!json_is_number(json_object_get(neighbour_ptr, "latency"))) {
+        missing_latency++;
+      }
+      edge.latency = pareto_get_number(neighbour_ptr, "latency", 0.0);
+      if (0.0 > edge.latency) {
+        edge.latency = 0.0;
+      }
+      edge.throughput = HUGE_VAL;
+      element_ptr = json_object_get(neighbour_ptr, "throughput");
+      if (json_is_object(element_ptr)) {
+        edge.throughput = pareto_get_number(element_ptr, "available", HUGE_VAL);
+      }
+
+      // duplicate link: keep the better one, keep both if neither dominates the other
+      if (source == last_source[position]) {
+        merged = &graph->edges[last_edge[position]];
+        if (pareto_edge_dominates(merged, &edge)) {
+          continue;
+        }
+        if (pareto_edge_dominates(&edge, merged)) {
+          *merged = edge;
+          continue;
+        }
+      }
+      last_source[position] = source;
+      last_edge[position] = graph->edge_count;
+      graph->edges[graph->edge_count] = edge;
+      graph->edge_count++;
+      graph_node->edge_count++;
+    }
+  }
+  free(last_source);
+  free(last_edge);
+
+  report_dangling_references(dangling, sort_unique_ids(dangling, dangling_count));
+  free(dangling);
+  if (0 < missing_latency) {
+    fprintf(stderr, "%zu links have no valid \"latency\", assuming 0\n", missing_latency);
+  }
+
+  return graph;
+}
+
+
+/*
+ * Release a graph created by json_data_to_pareto_graph().
+ * @param graph to be released (may be NULL)
+ */
+void pareto_graph_free(pareto_graph_t *graph) {
+  if (NULL == graph) {
+    return;
+  }
+  free(graph->nodes);
+  free(graph->edges);
+  node_index_free(&graph->index);
+  free(graph);
+}
+
+
+/*
+ * Check whether label "a" is at least as good as label "b" in all used metrics.
+ * Latency is minimised, throughput and energy are maximised.
+ * @returns 1 if "a" weakly dominates "b", 0 otherwise
+ */
+static int pareto_weakly_dominates(const double *a, const double *b, unsigned int metric_count) {
+  if (a[PARETO_METRIC_LATENCY] > b[PARETO_METRIC_LATENCY]) {
+    return 0;
+  }
+  if ((1 < metric_count) && (a[PARETO_METRIC_THROUGHPUT] < b[PARETO_METRIC_THROUGHPUT])) {
+    return 0;
+  }
+  if ((2 < metric_count) && (a[PARETO_METRIC_ENERGY] < b[PARETO_METRIC_ENERGY])) {
+    return 0;
+  }
+  return 1;
+}
+
+
+/*
+ * Check whether any label of a bag weakly dominates the given metric values.
+ * @returns 1 if the values are dominated, 0 otherwise
+ */
+static int pareto_bag_dominates(pareto_bag_t *bag, pareto_label_t *pool,
+                                const double *cost, unsigned int metric_count) {
+  size_t i = 0;  //< index in the bag
+
+  for (i = 0; i < bag->size; i++) {
+    if (pareto_weakly_dominates(pool[bag->labels[i]].cost, cost, metric_count)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+
+/*
+ * Build the hop list of a label by following its predecessors.
+ * @returns SRP_node_list_t pointer in case of success, NULL otherwise
+ */
+static SRP_node_list_t* pareto_label_to_route(pareto_graph_t *graph, pareto_label_t *pool, size_t label) {
+  SRP_node_list_t *route = NULL;           //< route to be constructed
+  SRP_node_list_element_t *hop = NULL;     //< current hop to be prepended
+
+  route = (SRP_node_list_t*)calloc(1, sizeof(SRP_node_list_t));
+  if (NULL == route) {
+    return NULL;
+  }
+
+  while (1) {
+    hop = (SRP_node_list_element_t*)calloc(1, sizeof(SRP_node_list_element_t));
+    if (NULL == hop) {
+      free_route(route);
+      return NULL;
+    }
+    hop->id = graph->nodes[pool[label].node].id;
+    hop->next = (struct SRP_node_list_element_t*)route->start;
+    route->start = hop;
+    if (pool[label].pred == label) {
+      break;
+    }
+    label = pool[label].pred;
+  }
+
+  return route;
+}
+
+
+/*
+ * @brief Compute all Pareto-optimal paths between two nodes in one search.
+ * Only the first "metric_count" metrics (in PARETO_METRIC_* order) are used to
+ * decide dominance, the remaining ones are reported only. Labels dominated by
+ * another label at the same node or at the destination are pruned. At most
+ * "max_labels" labels are kept per node; further non-dominated labels are
+ * dropped and a warning is printed, so the result may then be incomplete.
+ *
+ * @param graph to be searched
+ * @param from ID of the start node
+ * @param to ID of the destination node
+ * @param metric_count number of metrics to be optimised (1 to PARETO_METRIC_COUNT)
+ * @param max_labels upper bound of labels kept per node (0 selects PARETO_DEFAULT_MAX_LABELS)
+ * @returns list of Pareto-optimal paths sorted by latency, NULL if there is none or in case of errors
+ * @see pareto_select(pareto_path_t *paths, SRP_ObjectiveFunction_t *of)
+ */
+pareto_path_t* pareto_route(pareto_graph_t *graph, long long from, long long to,
+                            unsigned int metric_count, size_t max_labels) {
+  pareto_node_t *start = NULL;          //< start node
+  pareto_node_t *finish = NULL;         //< destination node
+  pareto_label_t *pool = NULL;          //< all labels created so far (also the FIFO queue)
+  pareto_label_t *resized_pool = NULL;  //< pool after growing it
+  size_t pool_size = 0;                 //< number of labels in the pool
+  size_t pool_capacity = 0;             //< number of allocated labels
+  pareto_bag_t *bags = NULL;            //< non-dominated labels per node
+  pareto_bag_t *bag = NULL;             //< bag of the current target node
+  size_t *resized_bag = NULL;           //< bag entries after growing them
+  size_t current = 0;                   //< label currently extended
+  size_t i, j = 0;                      //< generic indices
+  pareto_edge_t *edge = NULL;           //< edge currently relaxed
+  double cost[PARETO_METRIC_COUNT];     //< metric values of the extended label
+  size_t dropped = 0;                   //< number of labels dropped due to "max_labels"
+  pareto_path_t *paths = NULL;          //< resulting paths
+  pareto_path_t *path = NULL;           //< path currently constructed
+  pareto_path_t **insert = NULL;        //< insert position keeping "paths" sorted
+
+  // sanity checks
+  if (NULL == graph) {
+    return NULL;
+  }
+  if ((1 > metric_count) || (PARETO_METRIC_COUNT < metric_count)) {
+    fprintf(stderr, "invalid number of metrics (%u) given\n", metric_count);
+    return NULL;
+  }
+  if (0 == max_labels) {
+    max_labels = PARETO_DEFAULT_MAX_LABELS;
+  }
+  start = pareto_find_node(graph, from);
+  if (NULL == start) {
+    fprintf(stderr, "start node %lli not found\n", from);
+    return NULL;
+  }
+  finish = pareto_find_node(graph, to);
+  if (NULL == finish) {
+    fprintf(stderr, "destination node %lli not found\n", to);
+    return NULL;
+  }
+
+  bags = (pareto_bag_t*)calloc(graph->node_count, sizeof(pareto_bag_t));
+  if (NULL == bags) {
+    fprintf(stderr, "allocating memory for the label sets failed\n");
+    return NULL;
+  }
+  pool_capacity = graph->node_count;
+  pool = (pareto_label_t*)malloc(pool_capacity * sizeof(pareto_label_t));
+  if (NULL == pool) {
+    fprintf(stderr, "allocating memory for the labels failed\n");
+    free(bags);
+    return NULL;
+  }
+
+  // start label
+  pool[0].node = (size_t)(start - graph->nodes);
+  pool[0].cost[PARETO_METRIC_LATENCY] = 0.0;
+  pool[0].cost[PARETO_METRIC_THROUGHPUT] = HUGE_VAL;
+  pool[0].cost[PARETO_METRIC_ENERGY] = start->energy;
+  pool[0].pred = 0;
+  pool[0].alive = 1;
+  pool_size = 1;
+  bags[pool[0].node].labels = (size_t*)malloc(sizeof(size_t));
+  if (NULL == bags[pool[0].node].labels) {
+    fprintf(stderr, "allocating memory for the label sets failed\n");
+    pool_size = 0;
+    goto cleanup;
+  }
+  bags[pool[0].node].labels[0] = 0;
+  bags[pool[0].node].size = 1;
+  bags[pool[0].node].capacity = 1;
+
+  // label-correcting search: the pool doubles as FIFO queue
+  for (current = 0; current < pool_size; current++) {
+    if (!pool[current].alive) {
+      continue;
+    }
+    for (i = 0; i < graph->nodes[pool[current].node].edge_count; i++) {
+      edge = &graph->edges[graph->nodes[pool[current].node].first_edge + i];
+      cost[PARETO_METRIC_LATENCY] = pool[current].cost[PARETO_METRIC_LATENCY] + edge->latency;
+      cost[PARETO_METRIC_THROUGHPUT] = pool[current].cost[PARETO_METRIC_THROUGHPUT];
+      if (edge->throughput < cost[PARETO_METRIC_THROUGHPUT]) {
+        cost[PARETO_METRIC_THROUGHPUT] = edge->throughput;
+      }
+      cost[PARETO_METRIC_ENERGY] = pool[current].cost[PARETO_METRIC_ENERGY];
+      if (graph->nodes[edge->target].energy < cost[PARETO_METRIC_ENERGY]) {
+        cost[PARETO_METRIC_ENERGY] = graph->nodes[edge->target].energy;
+      }
+
+      // prune against the destination and the target node (all metrics only get worse along a path)
+      if (pareto_bag_dominates(&bags[finish - graph->nodes], pool, cost, metric_count)) {
+        continue;
+      }
+      bag = &bags[edge->target];
+      if (pareto_bag_dominates(bag, pool, cost, metric_count)) {
+        continue;
+      }
+
+      // remove labels dominated by the new one
+      for (j = 0; j < bag->size; ) {
+        if (pareto_weakly_dominates(cost, pool[bag->labels[j]].cost, metric_count)) {
+          pool[bag->labels[j]].alive = 0;
+          bag->labels[j] = bag->labels[bag->size - 1];
+          bag->size--;
+        } else {
+          j++;
+        }
+      }
+
+      if (max_labels <= bag->size) {
+        dropped++;
+        continue;
+      }
+      if (bag->capacity == bag->size) {
+        resized_bag = (size_t*)realloc(bag->labels, 2 * (bag->capacity + 1) * sizeof(size_t));
+        if (NULL == resized_bag) {
+          fprintf(stderr, "allocating memory for the label sets failed\n");
+          pool_size = 0;
+          goto cleanup;
+        }
+        bag->labels = resized_bag;
+        bag->capacity = 2 * (bag->capacity + 1);
+      }
+      if (pool_capacity == pool_size) {
+        resized_pool = (pareto_label_t*)realloc(pool, 2 * pool_capacity * sizeof(pareto_label_t));
+        if (NULL == resized_pool) {
+          fprintf(stderr, "allocating memory for the labels failed\n");
+          pool_size = 0;
+          goto cleanup;
+        }
+        pool = resized_pool;
+        pool_capacity *= 2;
+      }
+
+      pool[pool_size].node = edge->target;
+      memcpy(pool[pool_size].cost, cost, sizeof(cost));
+      pool[pool_size].pred = current;
+      pool[pool_size].alive = 1;
+      bag->labels[bag->size] = pool_size;
+      bag->size++;
+      pool_size++;
+    }
+  }
+
+  if (0 < dropped) {
+    fprintf(stderr, "%zu labels dropped (limit of %zu labels per node), Pareto set may be incomplete\n",
+            dropped, max_labels);
+  }
+
+  // turn the labels at the destination into paths
+  bag = &bags[finish - graph->nodes];
+  for (i = 0; i < bag->size; i++) {
+    path = (pareto_path_t*)calloc(1, sizeof(pareto_path_t));
+    if (NULL == path) {
+      fprintf(stderr, "allocating memory for a path failed\n");
+      pareto_paths_free(paths);
+      paths = NULL;
+      break;
+    }
+    memcpy(path->cost, pool[bag->labels[i]].cost, sizeof(path->cost));
+    path->route = pareto_label_to_route(graph, pool, bag->labels[i]);
+    if (NULL == path->route) {
+      fprintf(stderr, "allocating memory for a route failed\n");
+      free(path);
+      pareto_paths_free(paths);
+      paths = NULL;
+      break;
+    }
+    insert = &paths;
+    while ((NULL != *insert) &&
+           ((*insert)->cost[PARETO_METRIC_LATENCY] <= path->cost[PARETO_METRIC_LATENCY])) {
+      insert = &(*insert)->next;
+    }
+    path->next = *insert;
+    *insert = path;
+  }
+
+cleanup:
+  for (i = 0; i < graph->node_count; i++) {
+    free(bags[i].labels);
+  }
+  free(bags);
+  free(pool);
+  return paths;
+}
+
+
+/*
+ * Map a criterion's metric identifier to a metric index.
+ * @returns PARETO_METRIC_* in case of success, -1 for metrics not handled here
+ */
+static int pareto_metric_index(const char *metric_identifier) {
+  if (NULL == metric_identifier) {
+    return -1;
+  }
+  if (0 == strcmp("latency", metric_identifier)) {
+    return PARETO_METRIC_LATENCY;
+  }
+  if (0 == strcmp("throughput", metric_identifier)) {
+    return PARETO_METRIC_THROUGHPUT;
+  }
+  if (0 == strcmp("node energy", metric_identifier)) {
+    return PARETO_METRIC_ENERGY;
+  }
+  return -1;
+}
+
+
+/*
+ * Check whether a path fulfils a single criterion.
+ * Criteria on other metrics are node criteria, already applied by json_data_to_pareto_graph().
+ * @returns 1 if the criterion is fulfilled or not applicable, 0 otherwise
+ */
+static int pareto_fulfils(pareto_path_t *path, SRP_RoutingCriterion_t *criterion) {
+  int metric = 0;        //< metric the criterion refers to
+  double value = 0.0;    //< value of the criterion
+  char *end = NULL;      //< end of the parsed value
+
+  metric = pareto_metric_index(criterion->metric_identifier);
+  if ((0 > metric) || (NULL == criterion->operator) || (NULL == criterion->value)) {
+    return 1;
+  }
+  value = strtod(criterion->value, &end);
+  if (end == criterion->value) {
+    fprintf(stderr, "value \"%s\" of criterion \"%s\" is not a number\n",
+            criterion->value, criterion->metric_identifier);
+    return 1;
+  }
+
+  if (0 == strcmp("<", criterion->operator)) {
+    return path->cost[metric] < value;
+  }
+  if (0 == strcmp("<=", criterion->operator)) {
+    return path->cost[metric] <= value;
+  }
+  if (0 == strcmp("==", criterion->operator)) {
+    return path->cost[metric] == value;
+  }
+  if (0 == strcmp(">=", criterion->operator)) {
+    return path->cost[metric] >= value;
+  }
+  if (0 == strcmp(">", criterion->operator)) {
+    return path->cost[metric] > value;
+  }
+  return 1;
+}
+
+
+/*
+ * @brief Pick one path from a set of Pareto-optimal paths.
+ * Criteria with the metric "latency", "throughput" or "node energy" and one of
+ * the operators "<", "<=", "==", ">=", ">" are constraints every picked path has
+ * to fulfil; all other criteria are node criteria that json_data_to_pareto_graph()
+ * already applied when building the graph. Among the remaining paths the metrics
+ * are compared in the order they appear in the criteria, followed by the metrics
+ * not mentioned (latency, throughput, node energy).
+ *
+ * @param paths as returned by pareto_route()
+ * @param of objective function to choose with (may be NULL)
+ * @returns the chosen element of "paths", NULL if no path fulfils all constraints
+ */
+pareto_path_t* pareto_select(pareto_path_t *paths, SRP_ObjectiveFunction_t *of) {
+  int order[PARETO_METRIC_COUNT];             //< order in which metrics are compared
+  int used[PARETO_METRIC_COUNT] = {0, 0, 0};  //< metrics already placed in "order"
+  int order_size = 0;                         //< number of metrics placed in "order"
+  int metric = 0;                             //< generic metric index
+  int i = 0;                                  //< index in "order"
+  int feasible = 0;                           //< current path fulfils all criteria
+  SRP_RoutingCriterion_t *criterion = NULL;   //< current criterion
+  pareto_path_t *path = NULL;                 //< current path
+  pareto_path_t *best = NULL;                 //< best path so far
+
+  if (NULL == paths) {
+    return NULL;
+  }
+
+  // metrics mentioned by the objective function are compared first
+  if (NULL != of) {
+    for (criterion = of->criteria; NULL != criterion;
+         criterion = (SRP_RoutingCriterion_t*)criterion->next) {
+      metric = pareto_metric_index(criterion->metric_identifier);
+      if ((0 <= metric) && !used[metric]) {
+        used[metric] = 1;
+        order[order_size++] = metric;
+      }
+    }
+  }
+  for (metric = 0; metric < PARETO_METRIC_COUNT; metric++) {
+    if (!used[metric]) {
+      order[order_size++] = metric;
+    }
+  }
+
+  for (path = paths; NULL != path; path = path->next) {
+    feasible = 1;
+    if (NULL != of) {
+      for (criterion = of->criteria; NULL != criterion;
+           criterion = (SRP_RoutingCriterion_t*)criterion->next) {
+        if (!pareto_fulfils(path, criterion)) {
+          feasible = 0;
+          break;
+        }
+      }
+    }
+    if (!feasible) {
+      continue;
+    }
+    if (NULL == best) {
+      best = path;
+      continue;
+    }
+    for (i = 0; i < order_size; i++) {
+      metric = order[i];
+      if (path->cost[metric] == best->cost[metric]) {
+        continue;
+      }
+      if ((PARETO_METRIC_LATENCY == metric) == (path->cost[metric] < best->cost[metric])) {
+        best = path;
+      }
+      break;
+    }
+  }
+
+  return best;
+}
+
+
+/*
+ * Release a list of paths returned by pareto_route().
+ * @param paths to be released (may be NULL)
+ */
+void pareto_paths_free(pareto_path_t *paths) {
+  pareto_path_t *next = NULL;  //< path following the current one
+
+  while (NULL != paths) {
+    next = paths->next;
+    free_route(paths->route);
+    free(paths);
+    paths = next;
+  }
+}
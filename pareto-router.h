@@ -0,0 +1,134 @@
+/* Multi-criteria (Pareto) router for SRP network data
+ *
+ * This router computes the set of Pareto-optimal paths between two
+ * nodes for up to three metrics in a single label-correcting search.
+ * An objective function picks one path from that set afterwards.
+ * This file is licensed under APGL(v3) or later.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <jansson.h>
+#include "SRP/srp.h"
+#ifndef SRPDATATYPES_H_
+	#include "srp_datatypes.h"
+#endif
+#include "data-parser.h"
+
+#ifndef PARETO_ROUTER_H_
+#define PARETO_ROUTER_H_
+
+#define PARETO_METRIC_LATENCY 0     //< sum of neighbour "latency" along the path (minimised)
+#define PARETO_METRIC_THROUGHPUT 1  //< smallest "available" throughput along the path (maximised)
+#define PARETO_METRIC_ENERGY 2      //< smallest "node energy" level along the path (maximised)
+#define PARETO_METRIC_COUNT 3       //< number of supported metrics
+
+#define PARETO_DEFAULT_MAX_LABELS 64 //< default bound on labels kept per node
+
+
+/**
+ * Directed edge between two nodes of a pareto_graph_t.
+ */
+typedef struct {
+  size_t target;      //< index of the target node in pareto_graph_t.nodes
+  double latency;     //< latency of the edge
+  double throughput;  //< available throughput of the edge
+} pareto_edge_t;
+
+/**
+ * Node of a pareto_graph_t; its edges are stored consecutively.
+ */
+typedef struct {
+  long long id;        //< node ID as given in the JSON data
+  double energy;       //< energy level of the node
+  size_t first_edge;   //< index of the first outgoing edge in pareto_graph_t.edges
+  size_t edge_count;   //< number of outgoing edges
+} pareto_node_t;
+
+/**
+ * Network annotated with the metrics used by the Pareto search.
+ * Nodes keep the order of the JSON data and are found by ID through "index".
+ */
+typedef struct {
+  pareto_node_t *nodes;  //< all nodes, in JSON order
+  size_t node_count;     //< number of nodes
+  pareto_edge_t *edges;  //< all edges, grouped by source node
+  size_t edge_count;     //< number of edges
+  node_index_t index;    //< node ID -> index in "nodes" (shared join, see node_index_init())
+} pareto_graph_t;
+
+/**
+ * One element of a set of Pareto-optimal paths.
+ */
+typedef struct pareto_path_t {
+  double cost[PARETO_METRIC_COUNT]; //< metric values of the path, indexed by PARETO_METRIC_*
+  SRP_node_list_t *route;           //< hops from start to finish
+  struct pareto_path_t *next;       //< next path in the set
+} pareto_path_t;
+
+
+/**
+ * Convert JSON-nodes data to a graph annotated with routing metrics.
+ * Nodes not fulfilling the node criteria of the objective function (see
+ * json_node_fulfils_objective_function()) are left out, together with all edges
+ * leading to them. "node energy" criteria are not applied to single nodes: they
+ * are path constraints checked by pareto_select(). Missing metrics fall back to
+ * neutral values: latency defaults to 0 (with a warning), throughput to unlimited
+ * and the energy level to 1.0.
+ * Neighbour IDs are resolved through the shared node index. Duplicate links between
+ * the same pair of nodes are merged into the better one (kept apart if neither is
+ * better in both latency and throughput), and neighbours referring to unknown nodes
+ * are skipped and reported once.
+ * @param nodes to be parsed (as returned by get_nodes())
+ * @param of objective function selecting the nodes to route over (may be NULL)
+ * @returns pareto_graph_t pointer in case of success, NULL otherwise
+ * @see pareto_graph_free(pareto_graph_t *graph)
+ */
+pareto_graph_t* json_data_to_pareto_graph(json_t *nodes, SRP_ObjectiveFunction_t *of);
+
+/**
+ * Release a graph created by json_data_to_pareto_graph().
+ * @param graph to be released (may be NULL)
+ */
+void pareto_graph_free(pareto_graph_t *graph);
+
+/**
+ * @brief Compute all Pareto-optimal paths between two nodes in one search.
+ * Only the first "metric_count" metrics (in PARETO_METRIC_* order) are used to
+ * decide dominance, the remaining ones are reported only. Labels dominated by
+ * another label at the same node or at the destination are pruned. At most
+ * "max_labels" labels are kept per node; further non-dominated labels are
+ * dropped and a warning is printed, so the result may then be incomplete.
+ *
+ * @param graph to be searched
+ * @param from ID of the start node
+ * @param to ID of the destination node
+ * @param metric_count number of metrics to be optimised (1 to PARETO_METRIC_COUNT)
+ * @param max_labels upper bound of labels kept per node (0 selects PARETO_DEFAULT_MAX_LABELS)
+ * @returns list of Pareto-optimal paths sorted by latency, NULL if there is none or in case of errors
+ * @see pareto_select(pareto_path_t *paths, SRP_ObjectiveFunction_t *of)
+ */
+pareto_path_t* pareto_route(pareto_graph_t *graph, long long from, long long to,
+                            unsigned int metric_count, size_t max_labels);
+
+/**
+ * @brief Pick one path from a set of Pareto-optimal paths.
+ * Criteria with the metric "latency", "throughput" or "node energy" and one of
+ * the operators "<", "<=", "==", ">=", ">" are constraints every picked path has
+ * to fulfil; all other criteria are node criteria that json_data_to_pareto_graph()
+ * already applied when building the graph. Among the remaining paths the metrics
+ * are compared in the order they appear in the criteria, followed by the metrics
+ * not mentioned (latency, throughput, node energy).
+ *
+ * @param paths as returned by pareto_route()
+ * @param of objective function to choose with (may be NULL)
+ * @returns the chosen element of "paths", NULL if no path fulfils all constraints
+ */
+pareto_path_t* pareto_select(pareto_path_t *paths, SRP_ObjectiveFunction_t *of);
+
+/**
+ * Release a list of paths returned by pareto_route().
+ * @param paths to be released (may be NULL)
+ */
+void pareto_paths_free(pareto_path_t *paths);
+
+#endif
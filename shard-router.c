@@ -0,0 +1,1207 @@
+/* Sharded router for SRP network data
+ *
+ * This router partitions a network into shards, each of which is converted
+ * and held by a separate local worker process. A coordinator routes across
+ * shard borders using boundary-node distance tables precomputed by the workers.
+ * This file is licensed under APGL(v3) or later.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <jansson.h>
+#include "SRP/srp.h"
+#ifndef SRPDATATYPES_H_
+	#include "srp_datatypes.h"
+#endif
+#include "data-parser.h"
+#include "shard-router.h"
+
+#define SHARD_UNREACHABLE LLONG_MAX  //< distance of nodes not reachable
+#define SHARD_NONE SIZE_MAX          //< marks a missing index
+
+#define SHARD_REQUEST_TABLE 1  //< distances from all entry to all exit nodes
+#define SHARD_REQUEST_FROM 2   //< distances from a node to all exit nodes (and the destination)
+#define SHARD_REQUEST_TO 3     //< distances from all entry nodes to a node
+#define SHARD_REQUEST_PATH 4   //< path between two nodes of the shard
+#define SHARD_REQUEST_QUIT 5   //< terminate the worker
+
+/*
+ * Request sent from the coordinator to a worker.
+ */
+typedef struct {
+  int type;        //< one of SHARD_REQUEST_*
+  long long from;  //< ID of the source node (if applicable)
+  long long to;    //< ID of the target node (if applicable)
+} shard_request_t;
+
+/*
+ * Shard as converted and held by a worker process.
+ */
+typedef struct {
+  SRP_Network_t *network;        //< converted nodes of the shard
+  resolved_network_t *resolved;  //< links inside the shard, resolved to node indices
+  size_t node_count;             //< number of nodes in the shard
+} shard_local_t;
+
+/*
+ * Entry of the priority queue used by the shortest-path searches.
+ */
+typedef struct {
+  long long distance;  //< tentative distance
+  size_t node;         //< index of the node
+} shard_heap_entry_t;
+
+/*
+ * Binary min-heap ordered by distance.
+ */
+typedef struct {
+  shard_heap_entry_t *entries;  //< heap entries
+  size_t size;                  //< number of used entries
+  size_t capacity;              //< number of allocated entries
+} shard_heap_t;
+
+/*
+ * Link of the overlay graph built by the coordinator.
+ */
+typedef struct {
+  shard_edge_t edge;  //< connected nodes and length
+  size_t shard;       //< shard to expand the link in, SHARD_NONE for links crossing shards
+} shard_overlay_edge_t;
+
+
+/*
+ * Insert an element into the heap.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_heap_push(shard_heap_t *heap, long long distance, size_t node) {
+  shard_heap_entry_t *resized = NULL;  //< entries after growing them
+  shard_heap_entry_t entry;            //< entry to be inserted
+  size_t position = 0;                 //< current position of the new entry
+
+  if (heap->capacity == heap->size) {
+    resized = (shard_heap_entry_t*)realloc(heap->entries, 2 * (heap->capacity + 8) * sizeof(shard_heap_entry_t));
+    if (NULL == resized) {
+      return 0;
+    }
+    heap->entries = resized;
+    heap->capacity = 2 * (heap->capacity + 8);
+  }
+
+  entry.distance = distance;
+  entry.node = node;
+  position = heap->size++;
+  while ((0 < position) && (heap->entries[(position - 1) / 2].distance > distance)) {
+    heap->entries[position] = heap->entries[(position - 1) / 2];
+    position = (position - 1) / 2;
+  }
+  heap->entries[position] = entry;
+  return 1;
+}
+
+
+/*
+ * Remove the element with the smallest distance from a non-empty heap.
+ * @returns the removed element
+ */
+static shard_heap_entry_t shard_heap_pop(shard_heap_t *heap) {
+  shard_heap_entry_t top = heap->entries[0];   //< element to be returned
+  shard_heap_entry_t last;                     //< element to be sifted down
+  size_t position = 0;                         //< current position of "last"
+  size_t child = 0;                            //< smaller child of "position"
+
+  last = heap->entries[--heap->size];
+  while (1) {
+    child = 2 * position + 1;
+    if (child >= heap->size) {
+      break;
+    }
+    if ((child + 1 < heap->size) && (heap->entries[child + 1].distance < heap->entries[child].distance)) {
+      child++;
+    }
+    if (heap->entries[child].distance >= last.distance) {
+      break;
+    }
+    heap->entries[position] = heap->entries[child];
+    position = child;
+  }
+  if (0 < heap->size) {
+    heap->entries[position] = last;
+  }
+  return top;
+}
+
+
+/*
+ * Write a buffer completely to a file descriptor.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_write_all(int fd, const void *buffer, size_t length) {
+  const char *position = (const char*)buffer;  //< remaining data
+  ssize_t written = 0;                         //< bytes written by the last call
+
+  while (0 < length) {
+    written = write(fd, position, length);
+    if (0 > written) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return 0;
+    }
+    position += written;
+    length -= (size_t)written;
+  }
+  return 1;
+}
+
+
+/*
+ * Read a buffer completely from a file descriptor.
+ * @returns 1 in case of success, 0 otherwise (including end of file)
+ */
+static int shard_read_all(int fd, void *buffer, size_t length) {
+  char *position = (char*)buffer;  //< remaining space
+  ssize_t received = 0;            //< bytes read by the last call
+
+  while (0 < length) {
+    received = read(fd, position, length);
+    if (0 > received) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return 0;
+    }
+    if (0 == received) {
+      return 0;
+    }
+    position += received;
+    length -= (size_t)received;
+  }
+  return 1;
+}
+
+
+/*
+ * Send a list of edges (preceded by their number).
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_send_edges(int fd, const shard_edge_t *edges, size_t count) {
+  if (!shard_write_all(fd, &count, sizeof(count))) {
+    return 0;
+  }
+  if (0 == count) {
+    return 1;
+  }
+  return shard_write_all(fd, edges, count * sizeof(shard_edge_t));
+}
+
+
+/*
+ * Receive a list of edges sent by shard_send_edges().
+ * @param edges receives the (allocated) list, NULL if it is empty
+ * @param count receives the number of edges
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_receive_edges(int fd, shard_edge_t **edges, size_t *count) {
+  *edges = NULL;
+  if (!shard_read_all(fd, count, sizeof(*count))) {
+    return 0;
+  }
+  if (0 == *count) {
+    return 1;
+  }
+  *edges = (shard_edge_t*)malloc(*count * sizeof(shard_edge_t));
+  if (NULL == *edges) {
+    return 0;
+  }
+  if (!shard_read_all(fd, *edges, *count * sizeof(shard_edge_t))) {
+    free(*edges);
+    *edges = NULL;
+    return 0;
+  }
+  return 1;
+}
+
+
+/*
+ * Append an edge to a growing list.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_append_edge(shard_edge_t **edges, size_t *count, size_t *capacity,
+                             long long from, long long to, long long weight) {
+  shard_edge_t *resized = NULL;  //< list after growing it
+
+  if (*capacity == *count) {
+    resized = (shard_edge_t*)realloc(*edges, 2 * (*capacity + 8) * sizeof(shard_edge_t));
+    if (NULL == resized) {
+      return 0;
+    }
+    *edges = resized;
+    *capacity = 2 * (*capacity + 8);
+  }
+  (*edges)[*count].from = from;
+  (*edges)[*count].to = to;
+  (*edges)[*count].weight = weight;
+  (*count)++;
+  return 1;
+}
+
+
+/*
+ * Append a node ID to a growing list.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_append_id(long long **ids, size_t *count, size_t *capacity, long long id) {
+  long long *resized = NULL;  //< list after growing it
+
+  if (*capacity == *count) {
+    resized = (long long*)realloc(*ids, 2 * (*capacity + 8) * sizeof(long long));
+    if (NULL == resized) {
+      return 0;
+    }
+    *ids = resized;
+    *capacity = 2 * (*capacity + 8);
+  }
+  (*ids)[(*count)++] = id;
+  return 1;
+}
+
+
+/*
+ * Comparison function for sorting overlay links by source node
+ */
+static int shard_overlay_compare(const void *a, const void *b) {
+  return compare_ids(&((const shard_overlay_edge_t*)a)->edge.from,
+                     &((const shard_overlay_edge_t*)b)->edge.from);
+}
+
+
+/*
+ * Find the shard assignment of a node.
+ * @returns pointer to the assignment in case of success, NULL otherwise
+ */
+static shard_assignment_t* shard_find_assignment(shard_network_t *network, long long id) {
+  size_t index = 0;  //< index of the node in the assignment
+
+  index = node_index_find(&network->index, id);
+  if (RESOLVED_NONE == index) {
+    return NULL;
+  }
+  return &network->assignment[index];
+}
+
+
+/*
+ * Assign every node to the shard of its "node owner".
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_partition_by_owner(shard_network_t *network, json_t *nodes) {
+  long long *owners = NULL;  //< owner of every node, later the distinct owners
+  long long *owner = NULL;   //< owner found by searching
+  json_t *element_ptr = NULL; //< "node owner" of the current node
+  size_t i = 0;              //< index in the node list
+
+  owners = (long long*)malloc(network->node_count * sizeof(long long));
+  if (NULL == owners) {
+    fprintf(stderr, "allocating memory for the node owners failed\n");
+    return 0;
+  }
+  for (i = 0; i < network->node_count; i++) {
+    element_ptr = json_object_get(json_array_get(nodes, network->assignment[i].json_index), "node owner");
+    if (!json_is_number(element_ptr)) {
+      fprintf(stderr, "node %lli has no valid \"node owner\"\n", network->assignment[i].id);
+      free(owners);
+      return 0;
+    }
+    owners[i] = json_integer_value(element_ptr);
+  }
+
+  network->shard_count = sort_unique_ids(owners, network->node_count);
+  network->shards = (shard_t*)calloc(network->shard_count, sizeof(shard_t));
+  if (NULL == network->shards) {
+    fprintf(stderr, "allocating memory for the shards failed\n");
+    free(owners);
+    return 0;
+  }
+  for (i = 0; i < network->shard_count; i++) {
+    network->shards[i].owner = owners[i];
+  }
+  for (i = 0; i < network->node_count; i++) {
+    element_ptr = json_object_get(json_array_get(nodes, network->assignment[i].json_index), "node owner");
+    owner = (long long*)bsearch(&(long long){json_integer_value(element_ptr)}, owners,
+                                network->shard_count, sizeof(long long), compare_ids);
+    network->assignment[i].shard = (size_t)(owner - owners);
+  }
+
+  free(owners);
+  return 1;
+}
+
+
+/*
+ * Assign the nodes to "shard_count" shards of equal size, grown breadth-first along neighbour links.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_partition_by_links(shard_network_t *network, json_t *nodes, size_t shard_count) {
+  size_t *queue = NULL;             //< breadth-first queue of assignment indices
+  size_t head, tail = 0;            //< read and write position in the queue
+  size_t seed = 0;                  //< next candidate to start a new breadth-first search from
+  size_t shard = 0;                 //< shard currently filled
+  size_t fill = 0;                  //< number of nodes in the current shard
+  size_t capacity = 0;              //< maximum number of nodes per shard
+  size_t index = 0;                 //< index in the neighbour array
+  json_t *neighbour_ptr = NULL;     //< current neighbour
+  shard_assignment_t *neighbour = NULL; //< assignment of the current neighbour
+
+  if (network->node_count < shard_count) {
+    shard_count = network->node_count;
+  }
+  network->shard_count = shard_count;
+  network->shards = (shard_t*)calloc(shard_count, sizeof(shard_t));
+  queue = (size_t*)malloc(network->node_count * sizeof(size_t));
+  if ((NULL == network->shards) || (NULL == queue)) {
+    fprintf(stderr, "allocating memory for the shards failed\n");
+    free(queue);
+    return 0;
+  }
+  for (index = 0; index < network->node_count; index++) {
+    network->assignment[index].shard = SHARD_NONE;
+  }
+  capacity = (network->node_count + shard_count - 1) / shard_count;
+
+  head = 0;
+  while (tail < network->node_count) {
+    if (head == tail) {
+      // start a new breadth-first search at the next unassigned node
+      while (SHARD_NONE != network->assignment[seed].shard) {
+        seed++;
+      }
+      queue[tail++] = seed;
+      network->assignment[seed].shard = shard;
+      if (++fill == capacity) {
+        shard++;
+        fill = 0;
+      }
+    }
+    json_array_foreach(json_object_get(json_array_get(nodes, network->assignment[queue[head]].json_index),
+                                       "neighbours"), index, neighbour_ptr) {
+      neighbour = shard_find_assignment(network, json_integer_value(json_object_get(neighbour_ptr, "node id")));
+      if ((NULL == neighbour) || (SHARD_NONE != neighbour->shard)) {
+        continue;
+      }
+      queue[tail++] = (size_t)(neighbour - network->assignment);
+      neighbour->shard = shard;
+      if (++fill == capacity) {
+        shard++;
+        fill = 0;
+      }
+    }
+    head++;
+  }
+  // rounding up the shard size may leave the last shards empty
+  network->shard_count = shard + ((0 < fill) ? 1 : 0);
+
+  free(queue);
+  return 1;
+}
+
+
+/*
+ * Collect the neighbour links crossing shard borders and the resulting entry and exit nodes.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_find_boundaries(shard_network_t *network, json_t *nodes) {
+  size_t cross_capacity = 0;       //< allocated crossing links
+  size_t *entry_capacity = NULL;   //< allocated entry nodes per shard
+  size_t *exit_capacity = NULL;    //< allocated exit nodes per shard
+  size_t i, index = 0;             //< index in node and neighbour array
+  json_t *neighbour_ptr = NULL;    //< current neighbour
+  json_t *element_ptr = NULL;      //< current JSON element
+  shard_assignment_t *source = NULL;    //< assignment of the current node
+  shard_assignment_t *neighbour = NULL; //< assignment of the current neighbour
+  int success = 0;                 //< return value
+
+  entry_capacity = (size_t*)calloc(network->shard_count, sizeof(size_t));
+  exit_capacity = (size_t*)calloc(network->shard_count, sizeof(size_t));
+  if ((NULL == entry_capacity) || (NULL == exit_capacity)) {
+    fprintf(stderr, "allocating memory for the shard boundaries failed\n");
+    goto cleanup;
+  }
+
+  for (i = 0; i < network->node_count; i++) {
+    source = &network->assignment[i];
+    json_array_foreach(json_object_get(json_array_get(nodes, source->json_index), "neighbours"),
+                       index, neighbour_ptr) {
+      neighbour = shard_find_assignment(network, json_integer_value(json_object_get(neighbour_ptr, "node id")));
+      if ((NULL == neighbour) || (neighbour->shard == source->shard)) {
+        continue;
+      }
+      element_ptr = json_object_get(neighbour_ptr, "weight");
+      if (!json_is_number(element_ptr)) {
+        continue;
+      }
+      if (!shard_append_edge(&network->cross_edges, &network->cross_edge_count, &cross_capacity,
+                             source->id, neighbour->id, json_integer_value(element_ptr)) ||
+          !shard_append_id(&network->shards[source->shard].exits, &network->shards[source->shard].exit_count,
+                           &exit_capacity[source->shard], source->id) ||
+          !shard_append_id(&network->shards[neighbour->shard].entries, &network->shards[neighbour->shard].entry_count,
+                           &entry_capacity[neighbour->shard], neighbour->id)) {
+        fprintf(stderr, "allocating memory for the shard boundaries failed\n");
+        goto cleanup;
+      }
+    }
+  }
+
+  for (i = 0; i < network->shard_count; i++) {
+    network->shards[i].entry_count = sort_unique_ids(network->shards[i].entries, network->shards[i].entry_count);
+    network->shards[i].exit_count = sort_unique_ids(network->shards[i].exits, network->shards[i].exit_count);
+  }
+  success = 1;
+
+cleanup:
+  free(entry_capacity);
+  free(exit_capacity);
+  return success;
+}
+
+
+/*
+ * Convert the nodes of one shard.
+ * @returns shard_local_t pointer in case of success, NULL otherwise
+ */
+static shard_local_t* shard_local_create(shard_network_t *network, json_t *nodes, size_t shard) {
+  shard_local_t *local = NULL;     //< shard to be constructed
+  json_t *shard_nodes = NULL;      //< JSON nodes belonging to the shard
+  size_t i = 0;                    //< index in the node list
+
+  local = (shard_local_t*)calloc(1, sizeof(shard_local_t));
+  shard_nodes = json_array();
+  if ((NULL == local) || (NULL == shard_nodes)) {
+    free(local);
+    return NULL;
+  }
+  for (i = 0; i < network->node_count; i++) {
+    if (shard != network->assignment[i].shard) {
+      continue;
+    }
+    if (0 != json_array_append(shard_nodes, json_array_get(nodes, network->assignment[i].json_index))) {
+      json_decref(shard_nodes);
+      free(local);
+      return NULL;
+    }
+    local->node_count++;
+  }
+
+  local->network = json_data_to_network(shard_nodes);
+  json_decref(shard_nodes);
+  if (NULL == local->network) {
+    free(local);
+    return NULL;
+  }
+
+  // links into other shards would show up as dangling references, so those are not collected
+  local->resolved = resolve_network(local->network, RESOLVE_RELEASE_NEIGHBOURS | RESOLVE_SKIP_DANGLING);
+  if (NULL == local->resolved) {
+    free_network(local->network);
+    free(local);
+    return NULL;
+  }
+
+  return local;
+}
+
+
+/*
+ * Find a node of a shard by its ID.
+ * @returns index of the node in case of success, SHARD_NONE otherwise
+ */
+static size_t shard_local_find(shard_local_t *local, long long id) {
+  size_t index = 0;  //< index of the node in the resolved network
+
+  index = resolved_network_find(local->resolved, id);
+  if (RESOLVED_NONE == index) {
+    return SHARD_NONE;
+  }
+  return index;
+}
+
+
+/*
+ * Shortest-path search inside a shard, stopping once all targets are settled.
+ * @param local shard to be searched
+ * @param source index of the start node
+ * @param is_target marks the nodes to be settled (NULL to search the whole shard)
+ * @param target_count number of marked nodes
+ * @param distance receives the distance of every node
+ * @param pred receives the predecessor of every node
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_local_search(shard_local_t *local, size_t source, const char *is_target, size_t target_count,
+                              long long *distance, size_t *pred) {
+  shard_heap_t heap = {NULL, 0, 0};        //< priority queue
+  shard_heap_entry_t current;              //< entry currently settled
+  network_edge_t *edge = NULL;             //< current link
+  size_t target = 0;                       //< index of the current neighbour
+  size_t i = 0;                            //< index in the node list
+
+  for (i = 0; i < local->node_count; i++) {
+    distance[i] = SHARD_UNREACHABLE;
+    pred[i] = SHARD_NONE;
+  }
+  distance[source] = 0;
+  if (!shard_heap_push(&heap, 0, source)) {
+    return 0;
+  }
+
+  while (0 < heap.size) {
+    current = shard_heap_pop(&heap);
+    if (current.distance != distance[current.node]) {
+      continue;
+    }
+    if ((NULL != is_target) && is_target[current.node]) {
+      if (0 == --target_count) {
+        break;
+      }
+    }
+    for (i = local->resolved->first_edge[current.node]; i < local->resolved->first_edge[current.node + 1]; i++) {
+      edge = &local->resolved->edges[i];
+      target = edge->target;
+      if (current.distance + edge->weight < distance[target]) {
+        distance[target] = current.distance + edge->weight;
+        pred[target] = current.node;
+        if (!shard_heap_push(&heap, distance[target], target)) {
+          free(heap.entries);
+          return 0;
+        }
+      }
+    }
+  }
+
+  free(heap.entries);
+  return 1;
+}
+
+
+/*
+ * Calculate the distances from one node to a list of nodes inside a shard and append them.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_local_distances(shard_local_t *local, long long from, const long long *to, size_t to_count,
+                                 long long *distance, size_t *pred, char *is_target,
+                                 shard_edge_t **edges, size_t *count, size_t *capacity) {
+  size_t source = 0;        //< index of the start node
+  size_t target = 0;        //< index of the current target
+  size_t target_count = 0;  //< number of targets inside the shard
+  size_t i = 0;             //< index in the target list
+  int success = 1;          //< return value
+
+  source = shard_local_find(local, from);
+  if (SHARD_NONE == source) {
+    return 1;
+  }
+  for (i = 0; i < to_count; i++) {
+    target = shard_local_find(local, to[i]);
+    if ((SHARD_NONE != target) && !is_target[target]) {
+      is_target[target] = 1;
+      target_count++;
+    }
+  }
+  if (0 < target_count) {
+    success = shard_local_search(local, source, is_target, target_count, distance, pred);
+  }
+  for (i = 0; i < to_count; i++) {
+    target = shard_local_find(local, to[i]);
+    if (SHARD_NONE == target) {
+      continue;
+    }
+    if (success && is_target[target] && (SHARD_UNREACHABLE != distance[target])) {
+      success = shard_append_edge(edges, count, capacity, from, to[i], distance[target]);
+    }
+    is_target[target] = 0;
+  }
+  return success;
+}
+
+
+/*
+ * Serve requests of the coordinator until asked to quit.
+ * @returns exit status of the worker process
+ */
+static int shard_worker(shard_network_t *network, json_t *nodes, size_t shard, int request_fd, int response_fd) {
+  shard_t *own = &network->shards[shard];  //< shard served by this worker
+  shard_local_t *local = NULL;             //< converted nodes of the shard
+  shard_request_t request;                 //< current request
+  long long *distance = NULL;              //< distances of the last search
+  size_t *pred = NULL;                     //< predecessors of the last search
+  char *is_target = NULL;                  //< targets of the next search
+  shard_edge_t *edges = NULL;              //< response being built
+  size_t count, capacity = 0;              //< size of the response
+  long long *targets = NULL;               //< targets of a FROM request
+  long long *path = NULL;                  //< path of a PATH request
+  size_t i = 0;                            //< generic index
+  size_t node = 0;                         //< generic node index
+
+  local = shard_local_create(network, nodes, shard);
+  if (NULL == local) {
+    fprintf(stderr, "converting shard %zu failed\n", shard);
+    return 1;
+  }
+  distance = (long long*)malloc(local->node_count * sizeof(long long));
+  pred = (size_t*)malloc(local->node_count * sizeof(size_t));
+  is_target = (char*)calloc(local->node_count, sizeof(char));
+  targets = (long long*)malloc((own->exit_count + 1) * sizeof(long long));
+  path = (long long*)malloc(local->node_count * sizeof(long long));
+  if ((NULL == distance) || (NULL == pred) || (NULL == is_target) || (NULL == targets) || (NULL == path)) {
+    fprintf(stderr, "allocating memory for shard %zu failed\n", shard);
+    return 1;
+  }
+
+  while (shard_read_all(request_fd, &request, sizeof(request))) {
+    count = 0;
+    switch (request.type) {
+      case SHARD_REQUEST_TABLE:
+        for (i = 0; i < own->entry_count; i++) {
+          if (!shard_local_distances(local, own->entries[i], own->exits, own->exit_count,
+                                     distance, pred, is_target, &edges, &count, &capacity)) {
+            return 1;
+          }
+        }
+        break;
+
+      case SHARD_REQUEST_FROM:
+        memcpy(targets, own->exits, own->exit_count * sizeof(long long));
+        targets[own->exit_count] = request.to;
+        if (!shard_local_distances(local, request.from, targets, own->exit_count + 1,
+                                   distance, pred, is_target, &edges, &count, &capacity)) {
+          return 1;
+        }
+        break;
+
+      case SHARD_REQUEST_TO:
+        for (i = 0; i < own->entry_count; i++) {
+          if (!shard_local_distances(local, own->entries[i], &request.to, 1,
+                                     distance, pred, is_target, &edges, &count, &capacity)) {
+            return 1;
+          }
+        }
+        break;
+
+      case SHARD_REQUEST_PATH:
+        node = shard_local_find(local, request.to);
+        i = shard_local_find(local, request.from);
+        if ((SHARD_NONE != node) && (SHARD_NONE != i)) {
+          is_target[node] = 1;
+          if (!shard_local_search(local, i, is_target, 1, distance, pred)) {
+            return 1;
+          }
+          is_target[node] = 0;
+          if (SHARD_UNREACHABLE != distance[node]) {
+            for (i = local->node_count; SHARD_NONE != node; node = pred[node]) {
+              path[--i] = local->resolved->nodes[node]->id;
+            }
+            count = local->node_count - i;
+            memmove(path, &path[i], count * sizeof(long long));
+          }
+        }
+        if (!shard_write_all(response_fd, &count, sizeof(count)) ||
+            !shard_write_all(response_fd, path, count * sizeof(long long))) {
+          return 1;
+        }
+        continue;
+
+      case SHARD_REQUEST_QUIT:
+        return 0;
+
+      default:
+        fprintf(stderr, "shard %zu received unknown request %i\n", shard, request.type);
+        break;
+    }
+
+    if (!shard_send_edges(response_fd, edges, count)) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+
+/*
+ * Send a request to the worker of a shard.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_send_request(shard_t *shard, int type, long long from, long long to) {
+  shard_request_t request;  //< request to be sent
+
+  memset(&request, 0, sizeof(request));
+  request.type = type;
+  request.from = from;
+  request.to = to;
+  return shard_write_all(shard->request_fd, &request, sizeof(request));
+}
+
+
+/*
+ * @brief Partition JSON-nodes data into shards and start one worker process per shard.
+ * With SHARD_BY_OWNER every distinct "node owner" forms a shard, "shard_count" is ignored.
+ * With SHARD_BY_PARTITIONER "shard_count" shards of equal size are grown breadth-first
+ * along neighbour links, so neighbouring nodes tend to share a shard.
+ * Nodes not fulfilling the node criteria of the objective function (see
+ * json_node_fulfils_objective_function()) are left out before partitioning.
+ * Each worker converts only the nodes of its own shard and reports the shortest
+ * distances between the boundary nodes of its shard.
+ *
+ * @param nodes to be parsed (as returned by get_nodes())
+ * @param of objective function selecting the nodes to route over (may be NULL)
+ * @param partitioning SHARD_BY_OWNER or SHARD_BY_PARTITIONER
+ * @param shard_count number of shards to create with SHARD_BY_PARTITIONER
+ * @returns shard_network_t pointer in case of success, NULL otherwise
+ * @see shard_network_shutdown(shard_network_t *network)
+ */
+shard_network_t* shard_network_start(json_t *nodes, SRP_ObjectiveFunction_t *of, int partitioning, size_t shard_count) {
+  shard_network_t *network = NULL;  //< sharded network to be constructed
+  json_t *node_ptr = NULL;          //< current JSON node
+  json_t *element_ptr = NULL;       //< current JSON element
+  size_t i, j = 0;                  //< generic indices
+  int request_pipe[2];              //< coordinator -> worker
+  int response_pipe[2];             //< worker -> coordinator
+  pid_t pid = 0;                    //< process ID of a new worker
+
+  // sanity checks
+  if (NULL == nodes) {
+    return NULL;
+  }
+  if (!json_is_array(nodes)) {
+    return NULL;
+  }
+  if (0 == json_array_size(nodes)) {
+    return NULL;
+  }
+  if ((SHARD_BY_PARTITIONER == partitioning) && (0 == shard_count)) {
+    fprintf(stderr, "number of shards must not be zero\n");
+    return NULL;
+  }
+
+  network = (shard_network_t*)calloc(1, sizeof(shard_network_t));
+  if (NULL == network) {
+    fprintf(stderr, "allocating memory for the sharded network failed\n");
+    return NULL;
+  }
+  // a worker that terminated early must show up as a failed write (EPIPE), not kill the coordinator
+  network->sigpipe_handler = signal(SIGPIPE, SIG_IGN);
+  network->assignment = (shard_assignment_t*)calloc(json_array_size(nodes), sizeof(shard_assignment_t));
+  if ((NULL == network->assignment) || !node_index_init(&network->index, json_array_size(nodes))) {
+    fprintf(stderr, "allocating memory for the shard assignment failed\n");
+    shard_network_shutdown(network);
+    return NULL;
+  }
+  json_array_foreach(nodes, i, node_ptr) {
+    element_ptr = json_object_get(node_ptr, "node id");
+    if (!json_is_number(element_ptr)) {
+      fprintf(stderr, "node %zu has no valid \"node id\"\n", i);
+      shard_network_shutdown(network);
+      return NULL;
+    }
+    // nodes excluded by the objective function are not part of any shard
+    if (!json_node_fulfils_objective_function(node_ptr, of, 0)) {
+      continue;
+    }
+    if (!node_index_insert(&network->index, json_integer_value(element_ptr), network->node_count)) {
+      fprintf(stderr, "node %lli defined more than once\n", json_integer_value(element_ptr));
+      shard_network_shutdown(network);
+      return NULL;
+    }
+    network->assignment[network->node_count].id = json_integer_value(element_ptr);
+    network->assignment[network->node_count].json_index = i;
+    network->node_count++;
+  }
+  if (0 == network->node_count) {
+    fprintf(stderr, "no node fulfils the objective function\n");
+    shard_network_shutdown(network);
+    return NULL;
+  }
+
+  if (SHARD_BY_OWNER == partitioning) {
+    if (!shard_partition_by_owner(network, nodes)) {
+      shard_network_shutdown(network);
+      return NULL;
+    }
+  } else {
+    if (!shard_partition_by_links(network, nodes, shard_count)) {
+      shard_network_shutdown(network);
+      return NULL;
+    }
+  }
+  if (!shard_find_boundaries(network, nodes)) {
+    shard_network_shutdown(network);
+    return NULL;
+  }
+  fprintf(stdout, "%zu shards, %zu links crossing shard borders\n",
+          network->shard_count, network->cross_edge_count);
+
+  // start workers
+  fflush(NULL);
+  for (i = 0; i < network->shard_count; i++) {
+    if (0 != pipe(request_pipe)) {
+      fprintf(stderr, "creating request pipe for shard %zu failed\n", i);
+      shard_network_shutdown(network);
+      return NULL;
+    }
+    if (0 != pipe(response_pipe)) {
+      fprintf(stderr, "creating response pipe for shard %zu failed\n", i);
+      close(request_pipe[0]);
+      close(request_pipe[1]);
+      shard_network_shutdown(network);
+      return NULL;
+    }
+    pid = fork();
+    if (0 > pid) {
+      fprintf(stderr, "starting worker for shard %zu failed\n", i);
+      close(request_pipe[0]);
+      close(request_pipe[1]);
+      close(response_pipe[0]);
+      close(response_pipe[1]);
+      shard_network_shutdown(network);
+      return NULL;
+    }
+    if (0 == pid) {
+      // worker: only keep the own pipes
+      for (j = 0; j < i; j++) {
+        close(network->shards[j].request_fd);
+        close(network->shards[j].response_fd);
+      }
+      close(request_pipe[1]);
+      close(response_pipe[0]);
+      j = (size_t)shard_worker(network, nodes, i, request_pipe[0], response_pipe[1]);
+      fflush(NULL);
+      _exit((int)j);
+    }
+    close(request_pipe[0]);
+    close(response_pipe[1]);
+    network->shards[i].pid = pid;
+    network->shards[i].request_fd = request_pipe[1];
+    network->shards[i].response_fd = response_pipe[0];
+  }
+
+  // let all workers calculate their boundary tables in parallel
+  for (i = 0; i < network->shard_count; i++) {
+    if (!shard_send_request(&network->shards[i], SHARD_REQUEST_TABLE, 0, 0)) {
+      fprintf(stderr, "requesting boundary table of shard %zu failed\n", i);
+      shard_network_shutdown(network);
+      return NULL;
+    }
+  }
+  for (i = 0; i < network->shard_count; i++) {
+    if (!shard_receive_edges(network->shards[i].response_fd, &network->shards[i].table,
+                             &network->shards[i].table_size)) {
+      fprintf(stderr, "receiving boundary table of shard %zu failed\n", i);
+      shard_network_shutdown(network);
+      return NULL;
+    }
+  }
+
+  return network;
+}
+
+
+/*
+ * Append the edges of a list to the overlay graph.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_overlay_add(shard_overlay_edge_t **overlay, size_t *count, size_t *capacity,
+                             const shard_edge_t *edges, size_t edge_count, size_t shard) {
+  shard_overlay_edge_t *resized = NULL;  //< overlay after growing it
+  size_t i = 0;                          //< index in the edge list
+
+  if (*capacity < *count + edge_count) {
+    resized = (shard_overlay_edge_t*)realloc(*overlay, 2 * (*count + edge_count) * sizeof(shard_overlay_edge_t));
+    if (NULL == resized) {
+      return 0;
+    }
+    *overlay = resized;
+    *capacity = 2 * (*count + edge_count);
+  }
+  for (i = 0; i < edge_count; i++) {
+    (*overlay)[*count].edge = edges[i];
+    (*overlay)[*count].shard = shard;
+    (*count)++;
+  }
+  return 1;
+}
+
+
+/*
+ * Append a node to a route.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_route_append(SRP_node_list_t *route, SRP_node_list_element_t **last, long long id) {
+  SRP_node_list_element_t *hop = NULL;  //< new hop
+
+  hop = (SRP_node_list_element_t*)calloc(1, sizeof(SRP_node_list_element_t));
+  if (NULL == hop) {
+    return 0;
+  }
+  hop->id = id;
+  if (NULL == *last) {
+    route->start = hop;
+  } else {
+    (*last)->next = (struct SRP_node_list_element_t*)hop;
+  }
+  *last = hop;
+  return 1;
+}
+
+
+/*
+ * Append the hops of a link of the overlay graph (without its first node) to a route.
+ * @returns 1 in case of success, 0 otherwise
+ */
+static int shard_route_expand(shard_network_t *network, shard_overlay_edge_t *link,
+                              SRP_node_list_t *route, SRP_node_list_element_t **last) {
+  shard_t *shard = NULL;    //< shard the link runs through
+  long long *path = NULL;   //< hops received from the worker
+  size_t count = 0;         //< number of hops
+  size_t i = 0;             //< index in the hop list
+  int success = 1;          //< return value
+
+  if (SHARD_NONE == link->shard) {
+    return shard_route_append(route, last, link->edge.to);
+  }
+
+  shard = &network->shards[link->shard];
+  if (!shard_send_request(shard, SHARD_REQUEST_PATH, link->edge.from, link->edge.to) ||
+      !shard_read_all(shard->response_fd, &count, sizeof(count))) {
+    return 0;
+  }
+  if (0 == count) {
+    return 0;
+  }
+  path = (long long*)malloc(count * sizeof(long long));
+  if (NULL == path) {
+    return 0;
+  }
+  if (!shard_read_all(shard->response_fd, path, count * sizeof(long long))) {
+    free(path);
+    return 0;
+  }
+  for (i = 1; success && (i < count); i++) {
+    success = shard_route_append(route, last, path[i]);
+  }
+  free(path);
+  return success;
+}
+
+
+/*
+ * @brief Calculate the shortest path between two nodes across all shards.
+ * The path weights are the neighbour "weight" values; the distance equals the
+ * one of a shortest-path search over the unpartitioned (filtered) network.
+ * @note This is a routing mode of its own: the weight adjustments SRP_adjust_Network()
+ * applies before SRP_route() are not reproduced, so routes may differ from the default mode.
+ *
+ * @param network as returned by shard_network_start()
+ * @param from ID of the start node
+ * @param to ID of the destination node
+ * @param distance receives the length of the path (may be NULL)
+ * @returns path from start to finish in case of success, NULL otherwise
+ */
+SRP_node_list_t* shard_route(shard_network_t *network, long long from, long long to, long long *distance) {
+  shard_assignment_t *start = NULL;      //< assignment of the start node
+  shard_assignment_t *finish = NULL;     //< assignment of the destination node
+  shard_overlay_edge_t *overlay = NULL;  //< links of the overlay graph, sorted by source
+  size_t overlay_count = 0;              //< number of overlay links
+  size_t overlay_capacity = 0;           //< allocated overlay links
+  shard_edge_t *edges = NULL;            //< distances received from a worker
+  size_t edge_count = 0;                 //< number of received distances
+  long long *ids = NULL;                 //< nodes of the overlay graph, sorted
+  size_t id_count = 0;                   //< number of overlay nodes
+  size_t *first = NULL;                  //< first outgoing link of every overlay node
+  long long *overlay_distance = NULL;    //< distance of every overlay node
+  size_t *pred = NULL;                   //< link leading to every overlay node
+  size_t *links = NULL;                  //< links along the shortest path, backwards
+  size_t link_count = 0;                 //< number of links along the shortest path
+  shard_heap_t heap = {NULL, 0, 0};      //< priority queue
+  shard_heap_entry_t current;            //< entry currently settled
+  size_t source, target, node = 0;       //< overlay node indices
+  size_t i = 0;                          //< generic index
+  SRP_node_list_t *route = NULL;         //< route to be returned
+  SRP_node_list_element_t *last = NULL;  //< last hop of the route
+  long long *found = NULL;               //< result of searching an ID
+
+  if (NULL == network) {
+    return NULL;
+  }
+  start = shard_find_assignment(network, from);
+  if (NULL == start) {
+    fprintf(stderr, "start node %lli not found\n", from);
+    return NULL;
+  }
+  finish = shard_find_assignment(network, to);
+  if (NULL == finish) {
+    fprintf(stderr, "destination node %lli not found\n", to);
+    return NULL;
+  }
+
+  // overlay: boundary tables, crossing links and the distances from start / to destination
+  for (i = 0; i < network->shard_count; i++) {
+    if (!shard_overlay_add(&overlay, &overlay_count, &overlay_capacity,
+                           network->shards[i].table, network->shards[i].table_size, i)) {
+      goto cleanup;
+    }
+  }
+  if (!shard_overlay_add(&overlay, &overlay_count, &overlay_capacity,
+                         network->cross_edges, network->cross_edge_count, SHARD_NONE)) {
+    goto cleanup;
+  }
+  if (!shard_send_request(&network->shards[start->shard], SHARD_REQUEST_FROM, from, to) ||
+      !shard_receive_edges(network->shards[start->shard].response_fd, &edges, &edge_count) ||
+      !shard_overlay_add(&overlay, &overlay_count, &overlay_capacity, edges, edge_count, start->shard)) {
+    fprintf(stderr, "querying distances from node %lli failed\n", from);
+    goto cleanup;
+  }
+  free(edges);
+  edges = NULL;
+  if (!shard_send_request(&network->shards[finish->shard], SHARD_REQUEST_TO, from, to) ||
+      !shard_receive_edges(network->shards[finish->shard].response_fd, &edges, &edge_count) ||
+      !shard_overlay_add(&overlay, &overlay_count, &overlay_capacity, edges, edge_count, finish->shard)) {
+    fprintf(stderr, "querying distances to node %lli failed\n", to);
+    goto cleanup;
+  }
+  qsort(overlay, overlay_count, sizeof(shard_overlay_edge_t), shard_overlay_compare);
+
+  // overlay nodes with their outgoing links
+  ids = (long long*)malloc((2 * overlay_count + 2) * sizeof(long long));
+  if (NULL == ids) {
+    goto cleanup;
+  }
+  for (i = 0; i < overlay_count; i++) {
+    ids[id_count++] = overlay[i].edge.from;
+    ids[id_count++] = overlay[i].edge.to;
+  }
+  ids[id_count++] = from;
+  ids[id_count++] = to;
+  id_count = sort_unique_ids(ids, id_count);
+  first = (size_t*)malloc((id_count + 1) * sizeof(size_t));
+  overlay_distance = (long long*)malloc(id_count * sizeof(long long));
+  pred = (size_t*)malloc(id_count * sizeof(size_t));
+  if ((NULL == first) || (NULL == overlay_distance) || (NULL == pred)) {
+    goto cleanup;
+  }
+  for (i = 0, node = 0; node < id_count; node++) {
+    while ((i < overlay_count) && (overlay[i].edge.from < ids[node])) {
+      i++;
+    }
+    first[node] = i;
+    overlay_distance[node] = SHARD_UNREACHABLE;
+    pred[node] = SHARD_NONE;
+  }
+  first[id_count] = overlay_count;
+  found = (long long*)bsearch(&from, ids, id_count, sizeof(long long), compare_ids);
+  source = (size_t)(found - ids);
+  found = (long long*)bsearch(&to, ids, id_count, sizeof(long long), compare_ids);
+  target = (size_t)(found - ids);
+
+  // shortest path over the overlay graph
+  overlay_distance[source] = 0;
+  if (!shard_heap_push(&heap, 0, source)) {
+    goto cleanup;
+  }
+  while (0 < heap.size) {
+    current = shard_heap_pop(&heap);
+    if (current.distance != overlay_distance[current.node]) {
+      continue;
+    }
+    if (target == current.node) {
+      break;
+    }
+    for (i = first[current.node]; i < first[current.node + 1]; i++) {
+      found = (long long*)bsearch(&overlay[i].edge.to, ids, id_count, sizeof(long long), compare_ids);
+      node = (size_t)(found - ids);
+      if (current.distance + overlay[i].edge.weight < overlay_distance[node]) {
+        overlay_distance[node] = current.distance + overlay[i].edge.weight;
+        pred[node] = i;
+        if (!shard_heap_push(&heap, overlay_distance[node], node)) {
+          goto cleanup;
+        }
+      }
+    }
+  }
+  if (SHARD_UNREACHABLE == overlay_distance[target]) {
+    fprintf(stderr, "node %lli not reachable from node %lli\n", to, from);
+    goto cleanup;
+  }
+
+  // expand the overlay links into hops
+  links = (size_t*)malloc(id_count * sizeof(size_t));
+  route = (SRP_node_list_t*)calloc(1, sizeof(SRP_node_list_t));
+  if ((NULL == links) || (NULL == route) || !shard_route_append(route, &last, from)) {
+    free_route(route);
+    route = NULL;
+    goto cleanup;
+  }
+  for (node = target; SHARD_NONE != pred[node]; ) {
+    links[link_count++] = pred[node];
+    found = (long long*)bsearch(&overlay[pred[node]].edge.from, ids, id_count, sizeof(long long), compare_ids);
+    node = (size_t)(found - ids);
+  }
+  while (0 < link_count) {
+    if (!shard_route_expand(network, &overlay[links[--link_count]], route, &last)) {
+      fprintf(stderr, "expanding the route failed\n");
+      free_route(route);
+      route = NULL;
+      goto cleanup;
+    }
+  }
+  if (NULL != distance) {
+    *distance = overlay_distance[target];
+  }
+
+cleanup:
+  free(heap.entries);
+  free(links);
+  free(pred);
+  free(overlay_distance);
+  free(first);
+  free(ids);
+  free(edges);
+  free(overlay);
+  return route;
+}
+
+
+/*
+ * Stop all worker processes and release the sharded network.
+ * @param network to be released (may be NULL)
+ */
+void shard_network_shutdown(shard_network_t *network) {
+  size_t i = 0;  //< index in the shard list
+
+  if (NULL == network) {
+    return;
+  }
+  for (i = 0; (NULL != network->shards) && (i < network->shard_count); i++) {
+    if (0 != network->shards[i].pid) {
+      shard_send_request(&network->shards[i], SHARD_REQUEST_QUIT, 0, 0);
+      close(network->shards[i].request_fd);
+      close(network->shards[i].response_fd);
+      waitpid(network->shards[i].pid, NULL, 0);
+    }
+    free(network->shards[i].entries);
+    free(network->shards[i].exits);
+    free(network->shards[i].table);
+  }
+  free(network->shards);
+  free(network->cross_edges);
+  free(network->assignment);
+  node_index_free(&network->index);
+  if (SIG_ERR != network->sigpipe_handler) {
+    signal(SIGPIPE, network->sigpipe_handler);
+  }
+  free(network);
+}
@@ -0,0 +1,115 @@
+/* Sharded router for SRP network data
+ *
+ * This router partitions a network into shards, each of which is converted
+ * and held by a separate local worker process. A coordinator routes across
+ * shard borders using boundary-node distance tables precomputed by the workers.
+ * This file is licensed under APGL(v3) or later.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <jansson.h>
+#include "SRP/srp.h"
+#ifndef SRPDATATYPES_H_
+	#include "srp_datatypes.h"
+#endif
+#include "data-parser.h"
+
+#ifndef SHARD_ROUTER_H_
+#define SHARD_ROUTER_H_
+
+#define SHARD_BY_OWNER 0        //< one shard per "node owner"
+#define SHARD_BY_PARTITIONER 1  //< fixed number of shards grown along neighbour links
+
+
+/**
+ * Assignment of a node to a shard.
+ */
+typedef struct {
+  long long id;        //< node ID
+  size_t shard;        //< index of the shard holding the node
+  size_t json_index;   //< index of the node in the JSON "nodes" array
+} shard_assignment_t;
+
+/**
+ * Weighted connection between two nodes, either a neighbour link crossing
+ * shard borders or an entry of a distance table.
+ */
+typedef struct {
+  long long from;    //< ID of the source node
+  long long to;      //< ID of the target node
+  long long weight;  //< weight of the link / length of the shortest path
+} shard_edge_t;
+
+/**
+ * One shard and the worker process holding it.
+ */
+typedef struct {
+  long long owner;      //< "node owner" of all nodes in the shard (SHARD_BY_OWNER only)
+  pid_t pid;            //< process ID of the worker, 0 if not running
+  int request_fd;       //< pipe to send requests to the worker
+  int response_fd;      //< pipe to receive responses from the worker
+  long long *entries;   //< nodes reached by links from other shards, sorted
+  size_t entry_count;   //< number of entry nodes
+  long long *exits;     //< nodes with links into other shards, sorted
+  size_t exit_count;    //< number of exit nodes
+  shard_edge_t *table;  //< shortest distances from entry to exit nodes inside the shard
+  size_t table_size;    //< number of table entries
+} shard_t;
+
+/**
+ * Sharded network as seen by the coordinator.
+ */
+typedef struct {
+  shard_assignment_t *assignment;  //< shard of every node, in JSON order
+  size_t node_count;               //< number of nodes
+  node_index_t index;              //< node ID -> index in "assignment"
+  shard_t *shards;                 //< all shards
+  size_t shard_count;              //< number of shards
+  shard_edge_t *cross_edges;       //< neighbour links crossing shard borders
+  size_t cross_edge_count;         //< number of crossing links
+  void (*sigpipe_handler)(int);    //< SIGPIPE handler to restore on shutdown
+} shard_network_t;
+
+
+/**
+ * @brief Partition JSON-nodes data into shards and start one worker process per shard.
+ * With SHARD_BY_OWNER every distinct "node owner" forms a shard, "shard_count" is ignored.
+ * With SHARD_BY_PARTITIONER "shard_count" shards of equal size are grown breadth-first
+ * along neighbour links, so neighbouring nodes tend to share a shard.
+ * Nodes not fulfilling the node criteria of the objective function (see
+ * json_node_fulfils_objective_function()) are left out before partitioning.
+ * Each worker converts only the nodes of its own shard and reports the shortest
+ * distances between the boundary nodes of its shard.
+ *
+ * @param nodes to be parsed (as returned by get_nodes())
+ * @param of objective function selecting the nodes to route over (may be NULL)
+ * @param partitioning SHARD_BY_OWNER or SHARD_BY_PARTITIONER
+ * @param shard_count number of shards to create with SHARD_BY_PARTITIONER
+ * @returns shard_network_t pointer in case of success, NULL otherwise
+ * @see shard_network_shutdown(shard_network_t *network)
+ */
+shard_network_t* shard_network_start(json_t *nodes, SRP_ObjectiveFunction_t *of, int partitioning, size_t shard_count);
+
+/**
+ * @brief Calculate the shortest path between two nodes across all shards.
+ * The path weights are the neighbour "weight" values; the distance equals the
+ * one of a shortest-path search over the unpartitioned (filtered) network.
+ * @note This is a routing mode of its own: the weight adjustments SRP_adjust_Network()
+ * applies before SRP_route() are not reproduced, so routes may differ from the default mode.
+ *
+ * @param network as returned by shard_network_start()
+ * @param from ID of the start node
+ * @param to ID of the destination node
+ * @param distance receives the length of the path (may be NULL)
+ * @returns path from start to finish in case of success, NULL otherwise
+ */
+SRP_node_list_t* shard_route(shard_network_t *network, long long from, long long to, long long *distance);
+
+/**
+ * Stop all worker processes and release the sharded network.
+ * @param network to be released (may be NULL)
+ */
+void shard_network_shutdown(shard_network_t *network);
+
+#endif